@@ -1,6 +1,25 @@
 #include "../s21_matrix_oop.h"
 
 #include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+
+#include "../s21_matrix_async.h"
+#include "../s21_matrix_compressed.h"
+#include "../s21_matrix_csv.h"
+#include "../s21_matrix_memory.h"
+#include "../s21_matrix_shm.h"
+#include "../s21_matrix_trace.h"
+#include "../s21_matrix_tuning.h"
+#include "../s21_matrix_solvers.h"
+#include "../s21_matrix_tiled.h"
 
 TEST(S21Matrix_constructor_suite, true_test) {
   S21Matrix first_matrix;
@@ -514,6 +533,30 @@ TEST(InverseMatrix_suite, exceptional_test) {
   ASSERT_THROW(first_matrix.InverseMatrix(), std::invalid_argument);
 }
 
+TEST(InverseMatrix_suite, threshold_test) {
+  int mismatches = 0;
+
+  for (int seed = 1; seed < 40; ++seed) {
+    S21Matrix first_matrix(4, 4);
+    for (int i = 0; i < 16; ++i) {
+      first_matrix(i / 4, i % 4) = (seed * 37 + i * i * 11) % 19 - 9.5;
+    }
+    double det = fabs(first_matrix.Determinant());
+    if (det < 1) continue;
+    // scaled onto the singularity threshold, where rounding decides
+    S21Matrix scaled = first_matrix * pow(1e-7 / det, 0.25);
+    bool throws = false;
+    try {
+      scaled.InverseMatrix();
+    } catch (const std::invalid_argument&) {
+      throws = true;
+    }
+    mismatches += throws != (fabs(scaled.Determinant()) < 1e-7);
+  }
+
+  EXPECT_EQ(mismatches, 0);
+}
+
 TEST(index_operator_suite, true_test) {
   S21Matrix first_matrix(3, 3);
 
@@ -693,6 +736,1652 @@ TEST(MulNumber_operator_suite, num_test) {
   EXPECT_TRUE(second_matrix.EqMatrix(expected_result));
 }
 
+TEST(LU_suite, solve_test) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 2);
+
+  a.FillingMatrix();
+  a(0, 0) = 50;
+  b.FillingMatrix();
+  S21LU lu(a);
+  S21Matrix x = lu.Solve(b);
+  std::vector<double> y = lu.Solve(std::vector<double>{1, 2, 3});
+  S21Matrix column(3, 1);
+  column(0, 0) = y[0];
+  column(1, 0) = y[1];
+  column(2, 0) = y[2];
+  S21Matrix rhs(3, 1);
+  rhs(0, 0) = 1;
+  rhs(1, 0) = 2;
+  rhs(2, 0) = 3;
+
+  EXPECT_TRUE((a * x).EqMatrix(b));
+  EXPECT_TRUE((a * column).EqMatrix(rhs));
+  EXPECT_TRUE(a.Solve(b).EqMatrix(x));
+  EXPECT_NEAR(lu.Determinant(), -150, 1e-9);
+  EXPECT_NEAR(lu.LogAbsDeterminant(), log(150), 1e-9);
+  EXPECT_EQ(lu.DeterminantSign(), -1);
+}
+
+TEST(LU_suite, exceptional_test) {
+  S21Matrix a(3, 3);
+  S21Matrix b(2, 1);
+
+  a.FillingMatrix();
+  a(0, 0) = 50;
+
+  ASSERT_THROW(S21LU(S21Matrix(2, 3)), std::out_of_range);
+  ASSERT_THROW(S21LU(a).Solve(b), std::out_of_range);
+  ASSERT_THROW(S21LU(S21Matrix(3, 3)).Solve(a), std::invalid_argument);
+}
+
+TEST(Cholesky_suite, solve_test) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 3);
+
+  a(0, 0) = 4;
+  a(0, 1) = a(1, 0) = 12;
+  a(0, 2) = a(2, 0) = -16;
+  a(1, 1) = 37;
+  a(1, 2) = a(2, 1) = -43;
+  a(2, 2) = 98;
+  b.FillingMatrix();
+  S21Cholesky cholesky(a);
+
+  EXPECT_TRUE((a * cholesky.Solve(b)).EqMatrix(b));
+  EXPECT_TRUE(cholesky.Inverse().EqMatrix(a.InverseMatrix()));
+  EXPECT_NEAR(cholesky.Determinant(), 36, 1e-9);
+  EXPECT_NEAR(cholesky.LogDeterminant(), log(36), 1e-9);
+  ASSERT_THROW(S21Cholesky{b}, std::invalid_argument);
+}
+
+TEST(QR_suite, solve_test) {
+  S21Matrix a(3, 3);
+  S21Matrix b(3, 1);
+  S21Matrix tall(4, 2);
+  S21Matrix line(4, 1);
+
+  a.FillingMatrix();
+  a(0, 0) = 50;
+  b.FillingMatrix();
+  for (int i = 0; i < 4; ++i) {
+    tall(i, 0) = 1;
+    tall(i, 1) = i;
+    line(i, 0) = 2 + 3 * i;
+  }
+  S21QR qr(a);
+  S21Matrix fit = S21QR(tall).Solve(line);
+
+  EXPECT_TRUE((a * qr.Solve(b)).EqMatrix(b));
+  EXPECT_NEAR(qr.Determinant(), -150, 1e-9);
+  EXPECT_NEAR(fit(0, 0), 2, 1e-9);
+  EXPECT_NEAR(fit(1, 0), 3, 1e-9);
+  ASSERT_THROW(S21QR(tall).Determinant(), std::out_of_range);
+}
+
+TEST(Cache_suite, determinant_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCacheEnabled(true);
+  first_matrix(2, 2) = 56;
+
+  EXPECT_TRUE(first_matrix.Determinant() == -144);
+  EXPECT_TRUE(first_matrix.Determinant() == -144);
+  EXPECT_EQ(first_matrix.getCacheMisses(), 1);
+  EXPECT_EQ(first_matrix.getCacheHits(), 1);
+
+  first_matrix(0, 0) = 1000;
+
+  EXPECT_TRUE(first_matrix.Determinant() == 188856);
+  EXPECT_EQ(first_matrix.getCacheMisses(), 2);
+}
+
+TEST(Cache_suite, invalidate_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix second_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix(0, 0) = 50;
+  first_matrix.setCacheEnabled(true);
+  second_matrix.setCacheEnabled(true);
+  S21Matrix inverse = first_matrix.InverseMatrix();
+  std::size_t hash = first_matrix.Hash();
+
+  EXPECT_TRUE(first_matrix.InverseMatrix().EqMatrix(inverse));
+  EXPECT_EQ(first_matrix.Hash(), hash);
+  EXPECT_EQ(first_matrix.getCacheHits(), 2);
+
+  first_matrix.SumMatrix(second_matrix);
+  EXPECT_EQ(first_matrix.Hash(), hash);
+  first_matrix.MulNumber(2);
+  EXPECT_NE(first_matrix.Hash(), hash);
+  EXPECT_FALSE(first_matrix.InverseMatrix().EqMatrix(inverse));
+  first_matrix.setRows(2);
+  ASSERT_THROW(first_matrix.InverseMatrix(), std::invalid_argument);
+}
+
+TEST(Cache_suite, eq_matrix_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCacheEnabled(true);
+  S21Matrix second_matrix(first_matrix);
+
+  EXPECT_TRUE(second_matrix.isCacheEnabled());
+  EXPECT_TRUE(first_matrix.EqMatrix(second_matrix));
+  EXPECT_EQ(first_matrix.getCacheHits(), 1);
+
+  second_matrix(1, 1) = 100;
+
+  EXPECT_FALSE(first_matrix.EqMatrix(second_matrix));
+  EXPECT_FALSE(first_matrix.EqMatrix(second_matrix));
+  EXPECT_EQ(first_matrix.getCacheHits(), 2);
+  EXPECT_EQ(first_matrix.getCacheMisses(), 1);
+
+  first_matrix.setCacheEnabled(false);
+  EXPECT_EQ(first_matrix.getCacheHits(), 0);
+}
+
+TEST(Cache_suite, factorization_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix second_matrix(3, 1);
+  std::vector<double> values = {-1, 7, -8, 8, -7, -9, 5, -9, 5};
+
+  std::copy(values.begin(), values.end(), first_matrix.begin());
+  first_matrix.setCacheEnabled(true);
+  first_matrix.Solve(second_matrix);
+
+  // the factorization rounds this one to -183.00000000000003
+  EXPECT_EQ(first_matrix.Determinant(), -183);
+  EXPECT_EQ(first_matrix.getCacheMisses(), 2);
+  first_matrix.InverseMatrix();
+  EXPECT_EQ(first_matrix.getCacheHits(), 2);
+}
+
+TEST(Cache_suite, held_reference_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix(0, 0) = 50;
+  first_matrix.setCacheEnabled(true);
+  double& element = first_matrix(0, 0);
+
+  EXPECT_TRUE(first_matrix.Determinant() == -150);
+  element = 0;
+  EXPECT_TRUE(first_matrix.Determinant() == -150);
+  first_matrix(0, 0) = 0;
+  EXPECT_TRUE(first_matrix.Determinant() == 0);
+}
+
+TEST(Cache_suite, threads_test) {
+  S21Matrix first_matrix(6, 6);
+  S21Matrix identity(6, 6);
+
+  for (int i = 0; i < 36; ++i) {
+    first_matrix(i / 6, i % 6) = (i * i * 7) % 11 - 5;
+  }
+  for (int i = 0; i < 6; ++i) {
+    identity(i, i) = 1;
+  }
+  S21Matrix second_matrix(first_matrix);
+  double det = first_matrix.Determinant();
+  std::size_t hash = first_matrix.Hash();
+  first_matrix.setCacheEnabled(true);
+  second_matrix.setCacheEnabled(true);
+  std::vector<std::thread> workers;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&]() {
+      for (int i = 0; i < 200; ++i) {
+        if (fabs(first_matrix.Determinant() - det) > 1e-9 * fabs(det))
+          ++mismatches;
+        if (first_matrix.Hash() != hash) ++mismatches;
+        if (!first_matrix.EqMatrix(second_matrix)) ++mismatches;
+        if (!(first_matrix.InverseMatrix() * first_matrix).EqMatrix(identity))
+          ++mismatches;
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_NE(det, 0);
+  EXPECT_EQ(mismatches.load(), 0);
+  EXPECT_GE(first_matrix.getCacheHits(), 4 * 200 * 4 - 16);
+}
+
+TEST(index_operator_suite, const_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  const S21Matrix& const_matrix = first_matrix;
+
+  EXPECT_TRUE(const_matrix(2, 1) == 7);
+  EXPECT_TRUE(const_matrix.At(1, 2) == 5);
+  ASSERT_THROW(const_matrix(3, 0), std::out_of_range);
+}
+
+TEST(At_suite, true_test) {
+  S21Matrix first_matrix(2, 3);
+  S21Matrix expected_result(2, 3);
+
+  expected_result.FillingMatrix();
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      first_matrix.At(i, j) = i * 3 + j;
+    }
+  }
+
+  EXPECT_TRUE(first_matrix.EqMatrix(expected_result));
+}
+
+TEST(Row_suite, true_test) {
+  S21Matrix first_matrix(3, 4);
+
+  first_matrix.FillingMatrix();
+  std::span<double> row = first_matrix.Row(1);
+  row[3] = 100;
+  const S21Matrix& const_matrix = first_matrix;
+
+  EXPECT_EQ(row.size(), 4u);
+  EXPECT_TRUE(row[0] == 4);
+  EXPECT_TRUE(const_matrix.Row(1)[3] == 100);
+  EXPECT_TRUE(first_matrix(1, 3) == 100);
+  ASSERT_THROW(first_matrix.Row(3), std::out_of_range);
+}
+
+static_assert(std::contiguous_iterator<S21Matrix::iterator>);
+static_assert(std::contiguous_iterator<S21Matrix::const_iterator>);
+
+TEST(iterator_suite, algorithms_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix expected_result(3, 3);
+
+  first_matrix.FillingMatrix();
+  expected_result.FillingMatrix();
+  expected_result.MulNumber(2);
+  std::transform(first_matrix.begin(), first_matrix.end(),
+                 first_matrix.begin(), [](double x) { return x * 2; });
+  const S21Matrix& const_matrix = first_matrix;
+
+  EXPECT_TRUE(first_matrix.EqMatrix(expected_result));
+  EXPECT_TRUE(std::reduce(const_matrix.begin(), const_matrix.end()) == 72);
+  EXPECT_EQ(std::distance(const_matrix.cbegin(), const_matrix.cend()), 9);
+}
+
+TEST(MixedPrecision_suite, solve_test) {
+  S21Matrix a(40, 40);
+  S21Matrix b(40, 2);
+
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      a(i, j) = 1.0 / (1 + i + j) + (i == j ? 4 : 0);
+    }
+    b(i, 0) = i;
+    b(i, 1) = 1;
+  }
+  S21RefinementInfo info;
+  S21Matrix x = a.SolveMixed(b, &info);
+  S21Matrix residual = a * x - b;
+
+  EXPECT_TRUE(info.converged);
+  EXPECT_FALSE(info.fell_back);
+  EXPECT_GT(info.iterations, 0);
+  for (double value : residual) {
+    EXPECT_NEAR(value, 0, 1e-12);
+  }
+}
+
+TEST(MixedPrecision_suite, inverse_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix singular(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix(0, 0) = 50;
+  singular.FillingMatrix();
+  S21RefinementInfo info;
+
+  EXPECT_TRUE(
+      first_matrix.InverseMixed(&info).EqMatrix(first_matrix.InverseMatrix()));
+  EXPECT_TRUE(info.converged);
+  ASSERT_THROW(singular.InverseMixed(), std::invalid_argument);
+}
+
+TEST(MixedPrecision_suite, fallback_test) {
+  S21Matrix first_matrix(2, 2);
+  S21Matrix b(2, 1);
+
+  first_matrix(0, 0) = 1e300;
+  first_matrix(1, 1) = 1;
+  b(0, 0) = 1e300;
+  b(1, 0) = 2;
+  S21RefinementInfo info;
+  S21Matrix x = first_matrix.SolveMixed(b, &info);
+
+  EXPECT_TRUE(info.fell_back);
+  EXPECT_NEAR(x(0, 0), 1, 1e-12);
+  EXPECT_NEAR(x(1, 0), 2, 1e-12);
+}
+
+TEST(MixedPrecision_suite, inverse_fallback_test) {
+  S21Matrix first_matrix(2, 2);
+  S21Matrix second_matrix(2, 2);
+  S21RefinementInfo first_info, second_info;
+
+  first_matrix(0, 0) = 1e300;
+  first_matrix(1, 1) = 1;
+  second_matrix(0, 0) = 1e-60;
+  second_matrix(1, 1) = 1e80;
+  S21Matrix first_inverse = first_matrix.InverseMixed(&first_info);
+  S21Matrix second_inverse = second_matrix.InverseMixed(&second_info);
+
+  EXPECT_TRUE(first_info.fell_back);
+  EXPECT_TRUE(second_info.fell_back);
+  EXPECT_DOUBLE_EQ(first_inverse(0, 0), 1e-300);
+  EXPECT_DOUBLE_EQ(first_inverse(1, 1), 1);
+  EXPECT_DOUBLE_EQ(second_inverse(0, 0), 1e60);
+  EXPECT_DOUBLE_EQ(second_inverse(1, 1), 1e-80);
+  EXPECT_EQ(first_inverse(0, 1), 0);
+  EXPECT_EQ(second_inverse(1, 0), 0);
+}
+
+TEST(Async_suite, mul_matrix_test) {
+  S21Matrix first_matrix(70, 30);
+  S21Matrix second_matrix(30, 20);
+
+  first_matrix.FillingMatrix();
+  second_matrix.FillingMatrix();
+  std::vector<double> reported;
+  std::mutex reported_mutex;
+  std::future<S21Matrix> result = MulMatrixAsync(
+      first_matrix, second_matrix, S21CancellationToken(),
+      [&](double done) {
+        std::lock_guard<std::mutex> lock(reported_mutex);
+        reported.push_back(done);
+      });
+
+  EXPECT_TRUE(result.get().EqMatrix(first_matrix * second_matrix));
+  EXPECT_TRUE(std::is_sorted(reported.begin(), reported.end()));
+  EXPECT_TRUE(reported.back() == 1);
+}
+
+TEST(Async_suite, inverse_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix singular(3, 3);
+  S21Executor executor(2);
+
+  first_matrix.FillingMatrix();
+  first_matrix(0, 0) = 50;
+  singular.FillingMatrix();
+  std::future<S21Matrix> result = InverseMatrixAsync(
+      first_matrix, S21CancellationToken(), nullptr, executor);
+  std::future<S21Matrix> failed =
+      InverseMatrixAsync(singular, S21CancellationToken(), nullptr, executor);
+
+  EXPECT_EQ(executor.getThreadCount(), 2);
+  EXPECT_TRUE(result.get().EqMatrix(first_matrix.InverseMatrix()));
+  ASSERT_THROW(failed.get(), std::invalid_argument);
+}
+
+TEST(Async_suite, inverse_threshold_test) {
+  int mismatches = 0;
+
+  for (int seed = 1; seed < 40; ++seed) {
+    S21Matrix first_matrix(4, 4);
+    for (int i = 0; i < 16; ++i) {
+      first_matrix(i / 4, i % 4) = (seed * 37 + i * i * 11) % 19 - 9.5;
+    }
+    double det = fabs(first_matrix.Determinant());
+    if (det < 1) continue;
+    S21Matrix scaled = first_matrix * pow(1e-7 / det, 0.25);
+    bool throws = false;
+    try {
+      InverseMatrixAsync(scaled).get();
+    } catch (const std::invalid_argument&) {
+      throws = true;
+    }
+    mismatches += throws != (fabs(scaled.Determinant()) < 1e-7);
+  }
+
+  EXPECT_EQ(mismatches, 0);
+}
+
+TEST(Async_suite, cancel_test) {
+  S21Matrix first_matrix(200, 200);
+  S21CancellationToken token;
+
+  first_matrix.FillingMatrix();
+  token.Cancel();
+  std::future<S21Matrix> product =
+      MulMatrixAsync(first_matrix, first_matrix, token);
+  std::future<S21Matrix> inverse = InverseMatrixAsync(first_matrix, token);
+
+  EXPECT_TRUE(token.isCancelled());
+  ASSERT_THROW(product.get(), S21OperationCancelled);
+  ASSERT_THROW(inverse.get(), S21OperationCancelled);
+}
+
+TEST(Power_suite, true_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix(0, 0) = 50;
+  S21Matrix expected_result(first_matrix);
+  for (int i = 1; i < 5; ++i) {
+    expected_result *= first_matrix;
+  }
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; ++i) {
+    identity(i, i) = 1;
+  }
+
+  EXPECT_TRUE(first_matrix.Power(0).EqMatrix(identity));
+  EXPECT_TRUE(first_matrix.Power(1).EqMatrix(first_matrix));
+  EXPECT_TRUE(first_matrix.Power(5).EqMatrix(expected_result));
+  EXPECT_TRUE(first_matrix.Power(-1).EqMatrix(first_matrix.InverseMatrix()));
+}
+
+TEST(Power_suite, large_exponent_test) {
+  S21Matrix transition(2, 2);
+
+  transition(0, 0) = 0.9;
+  transition(0, 1) = 0.1;
+  transition(1, 0) = 0.5;
+  transition(1, 1) = 0.5;
+  S21Matrix stationary = transition.Power(1000000);
+
+  EXPECT_NEAR(stationary(0, 0), 5.0 / 6, 1e-9);
+  EXPECT_NEAR(stationary(1, 1), 1.0 / 6, 1e-9);
+  ASSERT_THROW(S21Matrix(2, 3).Power(2), std::out_of_range);
+}
+
+TEST(Exp_suite, true_test) {
+  S21Matrix zero(2, 2);
+  S21Matrix rotation(2, 2);
+  S21Matrix diagonal(2, 2);
+
+  rotation(0, 1) = 1;
+  rotation(1, 0) = -1;
+  diagonal(0, 0) = 10;
+  diagonal(1, 1) = -1;
+  S21Matrix exp_zero = zero.Exp();
+  S21Matrix exp_rotation = rotation.Exp();
+  S21Matrix exp_diagonal = diagonal.Exp();
+
+  EXPECT_TRUE(exp_zero(0, 0) == 1 && exp_zero(0, 1) == 0);
+  EXPECT_NEAR(exp_rotation(0, 0), cos(1), 1e-12);
+  EXPECT_NEAR(exp_rotation(0, 1), sin(1), 1e-12);
+  EXPECT_NEAR(exp_rotation(1, 0), -sin(1), 1e-12);
+  EXPECT_NEAR(exp_diagonal(0, 0) / exp(10), 1, 1e-12);
+  EXPECT_NEAR(exp_diagonal(1, 1), exp(-1), 1e-12);
+  ASSERT_THROW(S21Matrix(2, 3).Exp(), std::out_of_range);
+}
+
+TEST(CopyOnWrite_suite, share_test) {
+  S21Matrix first_matrix(5, 5);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCopyOnWrite(true);
+  S21Matrix second_matrix(first_matrix);
+  S21Matrix third_matrix;
+  third_matrix = first_matrix;
+
+  EXPECT_TRUE(second_matrix.isCopyOnWrite());
+  EXPECT_TRUE(first_matrix.isShared());
+  EXPECT_EQ(std::as_const(first_matrix).Data(),
+            std::as_const(second_matrix).Data());
+  EXPECT_EQ(std::as_const(first_matrix).Data(),
+            std::as_const(third_matrix).Data());
+  EXPECT_NE(first_matrix.Data(), std::as_const(third_matrix).Data());
+}
+
+TEST(CopyOnWrite_suite, detach_test) {
+  S21Matrix first_matrix(5, 5);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCopyOnWrite(true);
+  S21Matrix second_matrix(first_matrix);
+  S21Matrix third_matrix(first_matrix);
+  S21Matrix fourth_matrix(first_matrix);
+  S21Matrix fifth_matrix(first_matrix);
+  S21Matrix expected_result(5, 5);
+  expected_result.FillingMatrix();
+
+  second_matrix(0, 0) = 100;
+  third_matrix.SumMatrix(expected_result);
+  fourth_matrix.setRows(2);
+
+  EXPECT_TRUE(first_matrix.EqMatrix(expected_result));
+  EXPECT_TRUE(second_matrix(0, 0) == 100);
+  EXPECT_TRUE(third_matrix(2, 2) == 24);
+  EXPECT_EQ(fourth_matrix.getRows(), 2);
+  EXPECT_TRUE(first_matrix.isShared());
+  first_matrix.setCopyOnWrite(false);
+  EXPECT_FALSE(first_matrix.isShared());
+}
+
+TEST(CopyOnWrite_suite, held_reference_test) {
+  S21Matrix first_matrix(5, 5);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCopyOnWrite(true);
+  double& element = first_matrix(0, 0);
+  S21Matrix::iterator it = first_matrix.begin() + 1;
+  S21Matrix second_matrix(first_matrix);
+  S21Matrix third_matrix;
+  third_matrix = first_matrix;
+  element = 7;
+  *it = 8;
+
+  EXPECT_FALSE(first_matrix.isShared());
+  EXPECT_TRUE(std::as_const(first_matrix)(0, 0) == 7);
+  EXPECT_TRUE(std::as_const(second_matrix)(0, 0) == 0);
+  EXPECT_TRUE(std::as_const(third_matrix)(0, 1) == 1);
+
+  S21Matrix fourth_matrix(second_matrix);
+
+  EXPECT_TRUE(second_matrix.isShared());
+  EXPECT_TRUE(fourth_matrix.EqMatrix(second_matrix));
+}
+
+TEST(CopyOnWrite_suite, power_test) {
+  S21Matrix first_matrix(5, 5);
+  S21Matrix expected_result(5, 5);
+  S21Matrix original(5, 5);
+
+  for (int i = 0; i < 5; ++i) {
+    first_matrix(i, i) = 1;
+    first_matrix(i, (i + 1) % 5) = 0.5;
+  }
+  original = first_matrix;
+  expected_result = first_matrix;
+  for (int i = 1; i < 7; ++i) {
+    expected_result *= first_matrix;
+  }
+  first_matrix.setCopyOnWrite(true);
+  S21Matrix result = first_matrix.Power(7);
+
+  EXPECT_TRUE(first_matrix.EqMatrix(original));
+  EXPECT_TRUE(result.EqMatrix(expected_result));
+}
+
+TEST(CopyOnWrite_suite, threads_test) {
+  S21Matrix first_matrix(10, 10);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCopyOnWrite(true);
+  std::vector<std::thread> workers;
+  std::atomic<int> mismatches{0};
+  for (int t = 0; t < 4; ++t) {
+    workers.emplace_back([&first_matrix, &mismatches, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        S21Matrix copy(first_matrix);
+        copy(t, t) = -1;
+        if (std::as_const(first_matrix).At(t, t) == -1) ++mismatches;
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  EXPECT_EQ(mismatches.load(), 0);
+  EXPECT_FALSE(first_matrix.isShared());
+}
+
+TEST(InlineStorage_suite, boundary_test) {
+  S21Matrix first_matrix(4, 4);
+  S21Matrix second_matrix(4, 5);
+
+  first_matrix.FillingMatrix();
+  second_matrix.FillingMatrix();
+
+  EXPECT_TRUE(first_matrix.isInline());
+  EXPECT_FALSE(second_matrix.isInline());
+
+  first_matrix.setCols(5);
+
+  EXPECT_FALSE(first_matrix.isInline());
+  EXPECT_TRUE(first_matrix(3, 3) == 15);
+  EXPECT_TRUE(first_matrix(3, 4) == 0);
+
+  second_matrix.setRows(2);
+  second_matrix.setCols(2);
+
+  EXPECT_TRUE(second_matrix.isInline());
+  EXPECT_TRUE(second_matrix(0, 1) == 1);
+  EXPECT_TRUE(second_matrix(1, 1) == 6);
+}
+
+TEST(InlineStorage_suite, move_copy_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  S21Matrix second_matrix(first_matrix);
+  S21Matrix third_matrix(std::move(first_matrix));
+  std::vector<S21Matrix> matrices(10, second_matrix);
+  matrices.push_back(std::move(third_matrix));
+  matrices.back().setCopyOnWrite(true);
+  S21Matrix fourth_matrix(matrices.back());
+
+  EXPECT_EQ(first_matrix.getRows(), 0);
+  EXPECT_TRUE(second_matrix.isInline());
+  EXPECT_TRUE(matrices.back().isInline());
+  EXPECT_FALSE(fourth_matrix.isShared());
+  for (const S21Matrix& matrix : matrices) {
+    EXPECT_TRUE(matrix.EqMatrix(second_matrix));
+  }
+  EXPECT_TRUE(fourth_matrix.EqMatrix(second_matrix));
+  EXPECT_TRUE(second_matrix.Power(3).EqMatrix(second_matrix * second_matrix *
+                                              second_matrix));
+}
+
+static_assert(std::is_nothrow_move_constructible_v<S21Matrix>);
+static_assert(std::is_nothrow_move_assignable_v<S21Matrix>);
+static_assert(std::is_nothrow_swappable_v<S21Matrix>);
+static_assert(std::is_nothrow_destructible_v<S21Matrix>);
+
+TEST(S21Matrix_move_constructor_suite, vector_growth_test) {
+  std::vector<S21Matrix> matrices;
+  std::vector<const double*> storage;
+  for (int i = 0; i < 32; ++i) {
+    matrices.emplace_back(10, 10);
+    storage.push_back(std::as_const(matrices.back()).Data());
+  }
+
+  for (int i = 0; i < 32; ++i) {
+    EXPECT_EQ(std::as_const(matrices[i]).Data(), storage[i]);
+  }
+}
+
+TEST(S21Matrix_move_constructor_suite, cached_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix second_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  first_matrix.setCacheEnabled(true);
+  second_matrix.setCacheEnabled(true);
+  S21Matrix third_matrix(first_matrix);
+  second_matrix = std::move(first_matrix);
+  S21Matrix fourth_matrix(std::move(third_matrix));
+
+  EXPECT_EQ(first_matrix.getRows(), 0);
+  EXPECT_FALSE(first_matrix == second_matrix);
+  EXPECT_FALSE(second_matrix == first_matrix);
+  EXPECT_FALSE(third_matrix == fourth_matrix);
+  EXPECT_TRUE(second_matrix == fourth_matrix);
+}
+
+TEST(swap_suite, true_test) {
+  S21Matrix first_matrix(2, 2);
+  S21Matrix second_matrix(5, 5);
+
+  first_matrix.FillingMatrix();
+  S21Matrix expected_result(first_matrix);
+  swap(first_matrix, second_matrix);
+
+  EXPECT_EQ(first_matrix.getRows(), 5);
+  EXPECT_TRUE(second_matrix.EqMatrix(expected_result));
+
+  S21Matrix third_matrix;
+  third_matrix = std::move(second_matrix);
+
+  EXPECT_EQ(second_matrix.getRows(), 0);
+  EXPECT_TRUE(third_matrix.EqMatrix(expected_result));
+}
+
+TEST(Try_suite, status_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix second_matrix(2, 3);
+
+  first_matrix.FillingMatrix();
+
+  EXPECT_EQ(first_matrix.TrySumMatrix(second_matrix),
+            S21Status::kSizeMismatch);
+  EXPECT_EQ(first_matrix.TrySubMatrix(second_matrix),
+            S21Status::kSizeMismatch);
+  EXPECT_EQ(first_matrix.TryMulMatrix(second_matrix),
+            S21Status::kSizeMismatch);
+  EXPECT_EQ(second_matrix.TryDeterminant().error(), S21Status::kSizeMismatch);
+  EXPECT_EQ(first_matrix.TryInverseMatrix().error(), S21Status::kSingular);
+  EXPECT_EQ(first_matrix.TryGet(3, 0).error(), S21Status::kIndexOutOfRange);
+  EXPECT_EQ(first_matrix.TrySet(0, -1, 1), S21Status::kIndexOutOfRange);
+  ASSERT_THROW(first_matrix.TryInverseMatrix().value(), std::logic_error);
+}
+
+TEST(Try_suite, value_test) {
+  S21Matrix first_matrix(3, 3);
+  S21Matrix second_matrix(3, 3);
+
+  first_matrix.FillingMatrix();
+  second_matrix.FillingMatrix();
+
+  EXPECT_EQ(first_matrix.TrySet(0, 0, 50), S21Status::kOk);
+  EXPECT_EQ(second_matrix.TrySumMatrix(first_matrix), S21Status::kOk);
+  EXPECT_EQ(second_matrix.TrySubMatrix(first_matrix), S21Status::kOk);
+  EXPECT_EQ(second_matrix.TryMulMatrix(first_matrix), S21Status::kOk);
+
+  S21Expected<S21Matrix> inverse = first_matrix.TryInverseMatrix();
+  S21Expected<double> determinant = first_matrix.TryDeterminant();
+
+  EXPECT_TRUE(inverse.has_value());
+  EXPECT_TRUE(inverse->EqMatrix(first_matrix.InverseMatrix()));
+  EXPECT_TRUE(determinant && *determinant == -150);
+  EXPECT_TRUE(first_matrix.TryGet(0, 0).value() == 50);
+  S21Matrix expected_result(3, 3);
+  expected_result.FillingMatrix();
+  expected_result.MulMatrix(first_matrix);
+  EXPECT_TRUE(second_matrix.EqMatrix(expected_result));
+}
+
+TEST(Uninitialized_suite, fill_test) {
+  S21Matrix first_matrix(40, 30, kS21Uninitialized);
+
+  ASSERT_EQ(first_matrix.getRows(), 40);
+  ASSERT_EQ(first_matrix.getCols(), 30);
+  ASSERT_THROW(S21Matrix(0, 3, kS21Uninitialized), std::out_of_range);
+
+  std::iota(first_matrix.begin(), first_matrix.end(), 0.0);
+
+  EXPECT_EQ(first_matrix(39, 29), 1199);
+
+  first_matrix.setRows(42);
+  first_matrix.setCols(31);
+
+  EXPECT_EQ(first_matrix(39, 29), 1199);
+  EXPECT_EQ(first_matrix(39, 30), 0);
+  EXPECT_EQ(first_matrix(41, 0), 0);
+}
+
+TEST(Uninitialized_suite, overwrite_test) {
+  S21Matrix first_matrix(20, 30);
+  S21Matrix second_matrix(30, 20);
+  S21Matrix expected_result(20, 20);
+
+  std::iota(first_matrix.begin(), first_matrix.end(), 0.0);
+  std::fill(second_matrix.begin(), second_matrix.end(), 1.0);
+  for (int i = 0; i < 20; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      expected_result(i, j) = 30 * 30 * i + 435;
+    }
+  }
+
+  // the products overwrite recycled storage with garbage in it
+  for (int repeat = 0; repeat < 3; ++repeat) {
+    EXPECT_TRUE((first_matrix * second_matrix).EqMatrix(expected_result));
+  }
+  EXPECT_TRUE(first_matrix.Transpose().Transpose().EqMatrix(first_matrix));
+}
+
+TEST(Determinants_suite, batch_test) {
+  std::vector<S21Matrix> matrices;
+
+  for (int k = 0; k < 2000; ++k) {
+    S21Matrix m(3, 3);
+    m.FillingMatrix();
+    m(0, 0) = k;
+    matrices.push_back(m);
+  }
+  matrices.push_back(S21Matrix(5, 5));
+  std::vector<double> result = S21Matrix::Determinants(matrices);
+
+  ASSERT_EQ(result.size(), matrices.size());
+  for (std::size_t k = 0; k < matrices.size(); ++k) {
+    EXPECT_EQ(result[k], matrices[k].Determinant());
+  }
+  EXPECT_TRUE(S21Matrix::Determinants({}).empty());
+
+  matrices.push_back(S21Matrix(2, 3));
+
+  ASSERT_THROW(S21Matrix::Determinants(matrices), std::out_of_range);
+}
+
+TEST(Determinants_suite, parallel_complements_test) {
+  S21Matrix first_matrix(40, 40);
+
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      first_matrix(i, j) = ((i * 7 + j * 3) % 11) - 5 + (i == j) * 20;
+    }
+  }
+  S21Matrix result = first_matrix.CalcComplements();
+  // adj(A)^T * A = det(A) * I
+  S21Matrix check = result.Transpose() * first_matrix;
+  double det = first_matrix.Determinant();
+
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      EXPECT_NEAR(check(i, j), i == j ? det : 0, fabs(det) * 1e-9);
+    }
+  }
+  ASSERT_THROW(S21Matrix(1, 1).CalcComplements(), std::out_of_range);
+}
+
+TEST(Determinants_suite, parallel_for_test) {
+  S21Executor executor(4);
+  std::vector<int> hits(1000);
+  std::vector<int> nested(4 * 64);
+  std::vector<std::future<void>> outer;
+
+  executor.ParallelFor(1000, 7, [&hits](const auto& next) {
+    int begin, end;
+    while (next(begin, end)) {
+      for (int i = begin; i < end; ++i) ++hits[i];
+    }
+  });
+  auto failing = [](const auto& next) {
+    int begin, end;
+    while (next(begin, end)) {
+      if (begin == 500) throw std::runtime_error("failed");
+    }
+  };
+  // nested calls from every pool thread finish on the calling threads
+  for (int k = 0; k < 4; ++k) {
+    auto promise = std::make_shared<std::promise<void>>();
+    outer.push_back(promise->get_future());
+    executor.Submit([&executor, &nested, promise, k]() {
+      executor.ParallelFor(64, 1, [&nested, k](const auto& next) {
+        int begin, end;
+        while (next(begin, end)) nested[k * 64 + begin] = 1;
+      });
+      promise->set_value();
+    });
+  }
+  for (std::future<void>& f : outer) f.get();
+
+  EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+  EXPECT_EQ(std::count(nested.begin(), nested.end(), 1), 4 * 64);
+  ASSERT_THROW(executor.ParallelFor(1000, 1, failing), std::runtime_error);
+}
+
+TEST(MultiplyChain_suite, true_test) {
+  S21Matrix first_matrix(30, 4);
+  S21Matrix second_matrix(4, 30);
+  S21Matrix third_matrix(30, 5);
+  S21Matrix fourth_matrix(5, 7);
+  S21Matrix fifth_matrix(7, 30);
+  int seed = 0;
+
+  for (S21Matrix* m : {&first_matrix, &second_matrix, &third_matrix,
+                       &fourth_matrix, &fifth_matrix}) {
+    for (double& x : *m) x = (seed++ % 7) - 3;
+  }
+  S21Matrix expected_result = first_matrix * second_matrix * third_matrix *
+                              fourth_matrix * fifth_matrix;
+  S21Matrix result = S21Matrix::MultiplyChain(
+      {first_matrix, second_matrix, third_matrix, fourth_matrix, fifth_matrix});
+
+  EXPECT_TRUE(result.EqMatrix(expected_result));
+  EXPECT_EQ(result.getRows(), 30);
+  EXPECT_EQ(result.getCols(), 30);
+  EXPECT_TRUE(S21Matrix::MultiplyChain({first_matrix}).EqMatrix(first_matrix));
+  EXPECT_TRUE(S21Matrix::MultiplyChain({first_matrix, second_matrix})
+                  .EqMatrix(first_matrix * second_matrix));
+}
+
+TEST(MultiplyChain_suite, copy_on_write_test) {
+  S21Matrix first_matrix(5, 5);
+  S21Matrix second_matrix(5, 40);
+  S21Matrix third_matrix(40, 40);
+  S21Matrix fourth_matrix(40, 5);
+
+  first_matrix.FillingMatrix();
+  second_matrix.FillingMatrix();
+  third_matrix.FillingMatrix();
+  fourth_matrix.FillingMatrix();
+  S21Matrix expected_result =
+      first_matrix * second_matrix * third_matrix * fourth_matrix;
+  // the 5 x 40 intermediate is spare when the 5 x 5 result is formed
+  S21MemoryScope scope;
+  S21Matrix result = S21Matrix::MultiplyChain(
+      {first_matrix, second_matrix, third_matrix, fourth_matrix});
+  std::size_t held = scope.getAllocatedBytes() - scope.getFreedBytes();
+  result.setCopyOnWrite(true);
+  S21Matrix copy(result);
+  copy(4, 4) = 0;
+
+  EXPECT_EQ(held, 5 * 5 * sizeof(double));
+  EXPECT_TRUE(result.EqMatrix(expected_result));
+  EXPECT_EQ(copy(4, 3), expected_result(4, 3));
+  EXPECT_EQ(copy(4, 4), 0);
+}
+
+TEST(MultiplyChain_suite, false_test) {
+  S21Matrix first_matrix(3, 4);
+  S21Matrix second_matrix(3, 4);
+
+  ASSERT_THROW(S21Matrix::MultiplyChain({}), std::logic_error);
+  ASSERT_THROW(S21Matrix::MultiplyChain({first_matrix, second_matrix}),
+               std::logic_error);
+}
+
+TEST(SharedMemory_suite, attach_test) {
+  std::string name = "/s21_matrix_test_" + std::to_string(getpid());
+  S21Matrix first_matrix(20, 20);
+
+  std::iota(first_matrix.begin(), first_matrix.end(), 0.0);
+  S21Matrix published = S21SharedMemory::Publish(name, first_matrix);
+  S21Matrix writer = S21SharedMemory::Attach(name, S21ShmAccess::kReadWrite);
+  S21Matrix reader = S21SharedMemory::Attach(name, S21ShmAccess::kReadOnly);
+
+  EXPECT_TRUE(published.EqMatrix(first_matrix));
+  EXPECT_TRUE(reader.EqMatrix(first_matrix));
+  ASSERT_THROW(S21SharedMemory::Create(name, 2, 2), std::system_error);
+
+  writer(1, 2) = -1;
+
+  EXPECT_EQ(published(1, 2), -1);
+  EXPECT_EQ(std::as_const(reader)(1, 2), -1);
+
+  // a read-only matrix writes to its own copy
+  reader(0, 0) = 100;
+
+  EXPECT_EQ(reader(0, 0), 100);
+  EXPECT_EQ(published(0, 0), 0);
+  EXPECT_FALSE(reader.isShared());
+}
+
+TEST(SharedMemory_suite, process_test) {
+  std::string name = "/s21_matrix_test_" + std::to_string(getpid());
+  pid_t child;
+  int status = 0;
+
+  {
+    S21Matrix published = S21SharedMemory::Create(name, 64, 64);
+    child = fork();
+    if (child == 0) {
+      bool ok;
+      {
+        S21Matrix m = S21SharedMemory::Attach(name, S21ShmAccess::kReadWrite);
+        ok = m.getRows() == 64 && m.getCols() == 64;
+        m(63, 63) = 42;
+      }
+      _exit(ok ? 0 : 1);
+    }
+
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(published(63, 63), 42);
+  }
+
+  // the last reference removed the name
+  ASSERT_THROW(S21SharedMemory::Attach(name, S21ShmAccess::kReadOnly),
+               std::system_error);
+}
+
+TEST(Compressed_suite, conversion_test) {
+  S21Matrix first_matrix(3, 4);
+
+  first_matrix(0, 0) = 1;
+  first_matrix(0, 1) = -2.5;
+  first_matrix(0, 2) = 256;
+  first_matrix(0, 3) = 0.15625;
+  first_matrix(1, 0) = 65504;
+  first_matrix(1, 1) = 1e6;
+  first_matrix(1, 2) = ldexp(1.0, -20);
+  first_matrix(1, 3) = -1.0 / 3;
+  first_matrix(2, 0) = 127;
+  first_matrix(2, 1) = -64;
+  S21CompressedMatrix half(first_matrix, S21Precision::kFloat16);
+  S21CompressedMatrix bfloat(first_matrix, S21Precision::kBFloat16);
+  S21CompressedMatrix quantized(first_matrix, S21Precision::kInt8);
+  S21Matrix restored = quantized.Decompress();
+
+  EXPECT_EQ(half.getBytes(), 12 * sizeof(std::uint16_t));
+  EXPECT_EQ(half(0, 1), -2.5);
+  EXPECT_EQ(half(0, 3), 0.15625);
+  EXPECT_EQ(half(1, 0), 65504);
+  EXPECT_TRUE(std::isinf(half(1, 1)));
+  EXPECT_EQ(half(1, 2), ldexp(1.0, -20));
+  EXPECT_NEAR(half(1, 3), -1.0 / 3, 1e-3);
+  ASSERT_THROW(half(3, 0), std::out_of_range);
+  EXPECT_EQ(bfloat(0, 2), 256);
+  EXPECT_NEAR(bfloat(1, 1), 1e6, 1e6 / 128);
+  EXPECT_NEAR(bfloat(1, 3), -1.0 / 3, 1e-2);
+  EXPECT_EQ(quantized.getBytes(), 12 + 3 * sizeof(double));
+  EXPECT_EQ(restored(2, 0), 127);
+  EXPECT_EQ(restored(2, 1), -64);
+  for (int j = 0; j < 4; ++j) {
+    EXPECT_NEAR(restored(0, j), first_matrix(0, j), 256.0 / 254);
+  }
+}
+
+TEST(Compressed_suite, product_test) {
+  S21Matrix first_matrix(30, 20);
+  S21Matrix second_matrix(20, 10);
+  std::vector<double> x(20);
+
+  for (int i = 0; i < 30; ++i) {
+    for (int j = 0; j < 20; ++j) {
+      first_matrix(i, j) = sin(i * 20 + j);
+    }
+  }
+  std::iota(second_matrix.begin(), second_matrix.end(), -100.0);
+  for (int p = 0; p < 20; ++p) {
+    x[p] = second_matrix(p, 0);
+  }
+
+  for (S21Precision precision :
+       {S21Precision::kFloat16, S21Precision::kBFloat16, S21Precision::kInt8}) {
+    S21CompressedMatrix compressed(first_matrix, precision);
+    S21Matrix widened = compressed.Decompress();
+    S21Matrix expected_result = widened * second_matrix;
+    S21Matrix result = compressed.MulMatrix(second_matrix);
+    std::vector<double> y = compressed.MulVector(x);
+
+    for (int i = 0; i < 30; ++i) {
+      for (int j = 0; j < 10; ++j) {
+        EXPECT_NEAR(result(i, j), expected_result(i, j), 1e-9);
+      }
+      EXPECT_NEAR(y[i], expected_result(i, 0), 1e-9);
+    }
+    ASSERT_THROW(compressed.MulMatrix(first_matrix), std::logic_error);
+  }
+}
+
+TEST(LowRankInverse_suite, update_test) {
+  S21Matrix first_matrix(6, 6);
+  S21Matrix u(6, 2);
+  S21Matrix v(6, 2);
+  std::vector<double> column = {-1, 0, 2, 7, 1, 3};
+
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      first_matrix(i, j) = ((i * 5 + j * 3) % 7) - 3 + (i == j) * 10;
+    }
+    u(i, 0) = i - 2;
+    u(i, 1) = 1;
+    v(i, 0) = 0.5;
+    v(i, 1) = (i % 3) - 1;
+  }
+  S21LowRankInverse tracked(first_matrix);
+  tracked.Update(u, v);
+  tracked.ReplaceRow(2, {1, 2, 3, 4, 5, 6});
+  tracked.ReplaceColumn(4, column);
+  S21Matrix expected_matrix = first_matrix + u * v.Transpose();
+  for (int j = 0; j < 6; ++j) expected_matrix(2, j) = j + 1;
+  for (int i = 0; i < 6; ++i) expected_matrix(i, 4) = column[i];
+  S21Matrix identity = tracked.getInverse() * expected_matrix;
+
+  EXPECT_TRUE(tracked.getMatrix().EqMatrix(expected_matrix));
+  EXPECT_NEAR(tracked.getDeterminant(), expected_matrix.Determinant(),
+              fabs(expected_matrix.Determinant()) * 1e-10);
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 6; ++j) {
+      EXPECT_NEAR(identity(i, j), i == j, 1e-10);
+    }
+  }
+  EXPECT_EQ(tracked.getRecomputations(), 0);
+}
+
+TEST(LowRankInverse_suite, singular_test) {
+  S21Matrix first_matrix(3, 3);
+
+  first_matrix(0, 0) = 1;
+  first_matrix(1, 1) = 2;
+  first_matrix(2, 2) = 4;
+  S21LowRankInverse tracked(first_matrix);
+
+  EXPECT_EQ(tracked.getDeterminant(), 8);
+  // a copy of row 0 makes the matrix singular, the state stays untouched
+  ASSERT_THROW(tracked.ReplaceRow(1, {1, 0, 0}), std::invalid_argument);
+  EXPECT_TRUE(tracked.getMatrix().EqMatrix(first_matrix));
+  EXPECT_EQ(tracked.getDeterminant(), 8);
+
+  // nearly singular intermediate matrix: falls back to a full factorization
+  tracked.ReplaceRow(1, {1, 1e-12, 0});
+  tracked.ReplaceRow(1, {0, 3, 0});
+
+  EXPECT_GE(tracked.getRecomputations(), 1);
+  EXPECT_NEAR(tracked.getDeterminant(), 12, 1e-9);
+  EXPECT_NEAR(tracked.getInverse()(1, 1), 1.0 / 3, 1e-12);
+  ASSERT_THROW(tracked.ReplaceColumn(3, {1, 2, 3}), std::out_of_range);
+  ASSERT_THROW(tracked.Update(S21Matrix(2, 1), S21Matrix(3, 1)),
+               std::out_of_range);
+}
+
+TEST(LowRankInverse_suite, cached_source_test) {
+  S21Matrix first_matrix(5, 5);
+
+  for (int i = 0; i < 5; ++i) {
+    first_matrix(i, i) = i + 1;
+  }
+  first_matrix.setCacheEnabled(true);
+  first_matrix.setCopyOnWrite(true);
+  S21LowRankInverse tracked(first_matrix);
+  // the last of these 32 updates checks the drift, reading the matrix
+  for (int k = 0; k < 16; ++k) {
+    tracked.ReplaceRow(0, {k % 2 + 1.0, 0, 0, 0, 0});
+    tracked.ReplaceColumn(4, {0, 0, 0, 0, k % 3 + 5.0});
+  }
+  S21Matrix copy(tracked.getMatrix());
+
+  EXPECT_NEAR(tracked.getDeterminant(), 2 * 2 * 3 * 4 * 5, 1e-9);
+  EXPECT_TRUE(tracked.getMatrix().isShared());
+  EXPECT_EQ(copy(0, 0), 2);
+}
+
+TEST(Trace_suite, chrome_json_test) {
+  std::ostringstream out;
+  std::ostringstream cleared;
+
+  S21ClearTrace();
+  {
+    S21TraceScope scope("Outer", 3, 4);
+    S21TraceAllocation(256);
+    std::thread([]() { S21TraceScope inner("Inner\"quoted\"", 5, 6); })
+        .join();
+  }
+  S21WriteChromeTrace(out);
+  std::string json = out.str();
+
+  EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+  EXPECT_NE(json.find("\"name\":\"Outer\",\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(json.find("\"rows\":3,\"cols\":4,\"bytes\":256"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"Inner\\\"quoted\\\"\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"rows\":5,\"cols\":6,\"bytes\":0"),
+            std::string::npos);
+
+  S21ClearTrace();
+  S21WriteChromeTrace(cleared);
+
+  EXPECT_EQ(cleared.str().find("Outer"), std::string::npos);
+}
+
+TEST(Trace_suite, ring_test) {
+  std::ostringstream out;
+  int events = 0;
+
+  S21ClearTrace();
+  std::thread([]() {
+    for (int i = 0; i < S21_MATRIX_TRACE_CAPACITY + 10; ++i) {
+      S21TraceScope scope("Wrapped", i, 0);
+    }
+  }).join();
+  S21WriteChromeTrace(out);
+  std::string json = out.str();
+  for (std::size_t at = json.find("Wrapped"); at != std::string::npos;
+       at = json.find("Wrapped", at + 1)) {
+    ++events;
+  }
+
+  // only the latest events are kept
+  EXPECT_EQ(events, S21_MATRIX_TRACE_CAPACITY);
+  EXPECT_EQ(json.find("\"rows\":9,"), std::string::npos);
+  EXPECT_NE(json.find("\"rows\":10,"), std::string::npos);
+}
+
+TEST(Trace_suite, recycle_test) {
+  auto run_threads = []() {
+    for (int t = 0; t < 3 * S21_MATRIX_TRACE_RETAINED_THREADS; ++t) {
+      std::thread([]() { S21TraceScope scope("Recycled", 1, 1); }).join();
+    }
+  };
+  // the events named Recycled and the largest thread id among them
+  auto recycled = [](int& events, int& max_thread) {
+    std::ostringstream out;
+    S21WriteChromeTrace(out);
+    std::string json = out.str();
+    events = 0;
+    max_thread = 0;
+    for (std::size_t at = json.find("\"Recycled\""); at != std::string::npos;
+         at = json.find("\"Recycled\"", at + 1)) {
+      std::size_t tid = json.find("\"tid\":", at) + 6;
+      max_thread = std::max(max_thread, std::stoi(json.substr(tid)));
+      ++events;
+    }
+  };
+  int events = 0;
+  int max_thread = 0;
+  int later_events = 0;
+  int later_max_thread = 0;
+
+  S21ClearTrace();
+  run_threads();
+  recycled(events, max_thread);
+  run_threads();
+  recycled(later_events, later_max_thread);
+
+  // finished threads keep their events up to the limit and no rings are
+  // added for threads that come later
+  EXPECT_EQ(events, S21_MATRIX_TRACE_RETAINED_THREADS);
+  EXPECT_EQ(later_events, S21_MATRIX_TRACE_RETAINED_THREADS);
+  EXPECT_LE(later_max_thread, max_thread);
+}
+
+#ifdef S21_MATRIX_TRACING
+TEST(Trace_suite, operation_test) {
+  std::vector<S21Matrix> matrices(3, S21Matrix(5, 5));
+
+  for (S21Matrix& m : matrices) {
+    m.FillingMatrix();
+  }
+  S21ClearTrace();
+  S21Matrix::Determinants(matrices);
+  S21Matrix product = matrices[0] * matrices[1];
+  std::ostringstream out;
+  S21WriteChromeTrace(out);
+  std::string json = out.str();
+
+  EXPECT_NE(json.find("{\"name\":\"Determinants\",\"ph\":\"X\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"rows\":3,\"cols\":0,\"bytes\":0"),
+            std::string::npos);
+  EXPECT_NE(json.find("{\"name\":\"MulMatrix\",\"ph\":\"X\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"rows\":5,\"cols\":5,\"bytes\":200"),
+            std::string::npos);
+  EXPECT_EQ(json.find("\"name\":\"Transpose\""), std::string::npos);
+}
+#endif
+
+TEST(Memory_suite, accounting_test) {
+  std::size_t live = S21MemoryTracker::getLiveBytes();
+  S21MemoryScope scope;
+
+  {
+    S21Matrix first_matrix(100, 10);
+
+    EXPECT_EQ(S21MemoryTracker::getLiveBytes(), live + 8000);
+
+    S21Matrix second_matrix(first_matrix);
+    S21Matrix inline_matrix(4, 4);
+
+    EXPECT_EQ(S21MemoryTracker::getLiveBytes(), live + 16000);
+
+    {
+      S21MemoryScope inner;
+
+      second_matrix.setRows(50);
+
+      EXPECT_EQ(inner.getAllocatedBytes(), 4000);
+      EXPECT_EQ(inner.getFreedBytes(), 8000);
+      EXPECT_EQ(inner.getPeakBytes(), 4000);
+    }
+    EXPECT_GE(S21MemoryTracker::getPeakBytes(), live + 16000);
+  }
+
+  EXPECT_EQ(S21MemoryTracker::getLiveBytes(), live);
+  EXPECT_EQ(scope.getAllocatedBytes(), 20000);
+  EXPECT_EQ(scope.getFreedBytes(), 20000);
+  EXPECT_EQ(scope.getPeakBytes(), 20000);
+}
+
+TEST(Memory_suite, budget_test) {
+  std::size_t live = S21MemoryTracker::getLiveBytes();
+  S21Matrix first_matrix(100, 10);
+  S21Matrix second_matrix(10, 10);
+
+  S21MemoryTracker::setBudget(live + 10000);
+
+  ASSERT_THROW(S21Matrix(100, 10), S21MemoryBudgetExceeded);
+  ASSERT_THROW(first_matrix.setCols(20), std::bad_alloc);
+  EXPECT_EQ(first_matrix.getCols(), 10);
+  EXPECT_EQ(first_matrix.TryMulMatrix(second_matrix), S21Status::kOutOfMemory);
+  try {
+    S21Matrix third_matrix(first_matrix);
+    ADD_FAILURE();
+  } catch (const S21MemoryBudgetExceeded& error) {
+    EXPECT_EQ(error.getRequested(), 8000);
+    EXPECT_EQ(error.getBudget(), live + 10000);
+  }
+
+  S21MemoryTracker::setBudget(0);
+
+  EXPECT_EQ(S21MemoryTracker::getLiveBytes(), live + 8800);
+  ASSERT_NO_THROW(S21Matrix(100, 10));
+}
+
+TEST(Memory_suite, assignment_budget_test) {
+  std::size_t live = S21MemoryTracker::getLiveBytes();
+  S21Matrix first_matrix(100, 10);
+  S21Matrix second_matrix(5, 5);
+
+  second_matrix.FillingMatrix();
+  S21MemoryTracker::setBudget(live + 10000);
+
+  ASSERT_THROW(second_matrix = first_matrix, S21MemoryBudgetExceeded);
+  EXPECT_EQ(second_matrix.getRows(), 5);
+  EXPECT_EQ(second_matrix.getCols(), 5);
+  EXPECT_EQ(second_matrix(4, 4), 24);
+
+  S21MemoryTracker::setBudget(0);
+  second_matrix = first_matrix;
+
+  EXPECT_TRUE(second_matrix.EqMatrix(first_matrix));
+  EXPECT_EQ(S21MemoryTracker::getLiveBytes(), live + 16000);
+}
+
+TEST(Tiled_suite, conversion_test) {
+  S21Matrix first_matrix(70, 45);
+
+  std::iota(first_matrix.begin(), first_matrix.end(), 0.0);
+
+  for (S21TileOrder order : {S21TileOrder::kRowMajor, S21TileOrder::kMorton}) {
+    S21TiledMatrix tiled(first_matrix, order);
+    S21Matrix transposed = tiled.Transpose().ToMatrix();
+
+    ASSERT_EQ(tiled.getRows(), 70);
+    ASSERT_EQ(tiled.getCols(), 45);
+    EXPECT_EQ(tiled(69, 44), 70 * 45 - 1);
+    EXPECT_EQ(tiled(33, 40), 33 * 45 + 40);
+    EXPECT_TRUE(tiled.ToMatrix().EqMatrix(first_matrix));
+    EXPECT_TRUE(transposed.EqMatrix(first_matrix.Transpose()));
+    ASSERT_THROW(tiled(70, 0), std::out_of_range);
+
+    tiled(0, 1) = -5;
+
+    EXPECT_EQ(tiled.ToMatrix()(0, 1), -5);
+  }
+  ASSERT_THROW(S21TiledMatrix(0, 4), std::out_of_range);
+}
+
+TEST(Tiled_suite, arithmetic_test) {
+  S21Matrix first_matrix(70, 45);
+  S21Matrix second_matrix(45, 100);
+
+  for (int i = 0; i < 70; ++i) {
+    for (int j = 0; j < 45; ++j) first_matrix(i, j) = (i * 3 + j) % 11 - 5;
+  }
+  for (int i = 0; i < 45; ++i) {
+    for (int j = 0; j < 100; ++j) second_matrix(i, j) = (i + j * 7) % 13 - 6;
+  }
+  S21TiledMatrix tiled(first_matrix);
+  S21TiledMatrix row_major(first_matrix, S21TileOrder::kRowMajor);
+  S21TiledMatrix sum(first_matrix);
+  tiled.MulMatrix(S21TiledMatrix(second_matrix, S21TileOrder::kRowMajor));
+
+  EXPECT_TRUE(tiled.ToMatrix().EqMatrix(first_matrix * second_matrix));
+  ASSERT_THROW(tiled.MulMatrix(row_major), std::logic_error);
+
+  sum.SumMatrix(row_major);
+  sum.MulNumber(0.5);
+
+  EXPECT_TRUE(sum.EqMatrix(row_major));
+
+  sum.SubMatrix(row_major);
+
+  EXPECT_TRUE(sum.ToMatrix().EqMatrix(S21Matrix(70, 45)));
+  ASSERT_THROW(sum.SumMatrix(tiled), std::out_of_range);
+  EXPECT_FALSE(sum.EqMatrix(tiled));
+}
+
+TEST(Tuning_suite, file_test) {
+  std::string path = "s21_matrix_tuning_test_" + std::to_string(getpid());
+  S21TuningConfig config;
+  S21TuningConfig loaded;
+  S21TuningConfig defaults;
+
+  config.gemm_depth_block = 64;
+  config.transpose_block = 8;
+  config.elementwise_parallel_min = S21TuningConfig::kSerialOnly;
+
+  ASSERT_TRUE(S21SaveTuning(path, config));
+  ASSERT_TRUE(S21LoadTuning(path, loaded));
+  EXPECT_EQ(loaded.gemm_depth_block, 64);
+  EXPECT_EQ(loaded.gemm_width_block, S21TuningConfig().gemm_width_block);
+  EXPECT_EQ(loaded.transpose_block, 8);
+  EXPECT_EQ(loaded.elementwise_parallel_min, S21TuningConfig::kSerialOnly);
+
+  {
+    std::ofstream file(path);
+    file << "# comment\ntranspose_block -4\ngemm_width_block x\n"
+         << "unknown 7\nparallel_grain 100 # trailing\n"
+         << "elementwise_parallel_min 0\n";
+  }
+
+  ASSERT_TRUE(S21LoadTuning(path, defaults));
+  EXPECT_EQ(defaults.transpose_block, S21TuningConfig().transpose_block);
+  EXPECT_EQ(defaults.gemm_width_block, S21TuningConfig().gemm_width_block);
+  EXPECT_EQ(defaults.parallel_grain, 100);
+  EXPECT_EQ(defaults.elementwise_parallel_min, 0);
+  std::remove(path.c_str());
+  EXPECT_FALSE(S21LoadTuning(path, defaults));
+}
+
+TEST(Tuning_suite, parameters_test) {
+  S21TuningConfig original = S21Tuning();
+  S21TuningConfig config;
+  S21Matrix first_matrix(300, 77);
+  S21Matrix second_matrix(77, 50);
+
+  std::iota(first_matrix.begin(), first_matrix.end(), 0.0);
+  std::iota(second_matrix.begin(), second_matrix.end(), -500.0);
+  S21Matrix product = first_matrix * second_matrix;
+  S21Matrix transposed = first_matrix.Transpose();
+  S21Matrix doubled = first_matrix + first_matrix;
+  config.gemm_depth_block = 5;
+  config.gemm_width_block = 3;
+  config.transpose_block = 7;
+  config.elementwise_parallel_min = 0;
+  S21SetTuning(config);
+  S21Matrix sum = first_matrix;
+  sum.SumMatrix(first_matrix);
+
+  EXPECT_TRUE((first_matrix * second_matrix).EqMatrix(product));
+  EXPECT_TRUE(first_matrix.Transpose().EqMatrix(transposed));
+  EXPECT_TRUE(sum.EqMatrix(doubled));
+  sum.SubMatrix(first_matrix);
+  sum.MulNumber(2);
+  EXPECT_TRUE(sum.EqMatrix(doubled));
+  S21SetTuning(original);
+}
+
+TEST(Triangular_suite, solve_test) {
+  S21Matrix first_matrix(40, 40);
+  S21Matrix second_matrix(40, 300);
+
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      first_matrix(i, j) = i == j ? 4 + i % 3 : ((i * 7 + j) % 5) - 2;
+    }
+  }
+  std::iota(second_matrix.begin(), second_matrix.end(), -6000.0);
+  S21Matrix lower = first_matrix;
+  S21Matrix upper = first_matrix;
+  S21Matrix unit = first_matrix;
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      if (j > i) lower(i, j) = 0;
+      if (j < i) upper(i, j) = 0;
+      if (j > i) unit(i, j) = 0;
+    }
+    unit(i, i) = 1;
+  }
+  S21Matrix lower_x =
+      first_matrix.SolveTriangular(second_matrix, S21Triangle::kLower);
+  S21Matrix upper_x =
+      first_matrix.SolveTriangular(second_matrix, S21Triangle::kUpper);
+  S21Matrix unit_x =
+      first_matrix.SolveTriangular(second_matrix, S21Triangle::kLower, true);
+
+  EXPECT_TRUE((lower * lower_x).EqMatrix(second_matrix));
+  EXPECT_TRUE((upper * upper_x).EqMatrix(second_matrix));
+  EXPECT_TRUE((unit * unit_x).EqMatrix(second_matrix));
+
+  first_matrix(5, 5) = 0;
+
+  ASSERT_THROW(first_matrix.SolveTriangular(second_matrix, S21Triangle::kUpper),
+               std::invalid_argument);
+  ASSERT_THROW(first_matrix.SolveTriangular(S21Matrix(39, 2),
+                                            S21Triangle::kLower),
+               std::out_of_range);
+}
+
+TEST(Triangular_suite, rank_k_test) {
+  S21Matrix first_matrix(1000, 70);
+
+  for (int i = 0; i < 1000; ++i) {
+    for (int j = 0; j < 70; ++j) {
+      first_matrix(i, j) = ((i * 13 + j * 7) % 17) - 8;
+    }
+  }
+  S21Matrix expected_result = first_matrix.Transpose() * first_matrix;
+  S21Matrix wide = first_matrix.Transpose();
+  S21Matrix outer = first_matrix.MulTranspose();
+
+  EXPECT_TRUE(first_matrix.TransposeMul().EqMatrix(expected_result));
+  EXPECT_TRUE(wide.MulTranspose().EqMatrix(expected_result));
+  EXPECT_EQ(outer.getRows(), 1000);
+  EXPECT_TRUE(outer.EqMatrix(first_matrix * wide));
+}
+
+TEST(Csv_suite, round_trip_test) {
+  S21Matrix first_matrix(7, 5);
+  std::ostringstream out;
+  std::ostringstream semicolons;
+  S21CsvOptions options;
+  std::string path = "s21_matrix_csv_test_" + std::to_string(getpid());
+
+  for (int i = 0; i < 7; ++i) {
+    for (int j = 0; j < 5; ++j) {
+      first_matrix(i, j) = (i - 3) * 1e-7 / (j + 3) + j * 1e12 / 7;
+    }
+  }
+  first_matrix(0, 0) = -0.0;
+  first_matrix(6, 4) = 0.1;
+  S21WriteCsv(out, first_matrix);
+  S21WriteCsv(semicolons, first_matrix, ';');
+  options.delimiter = ';';
+  std::istringstream in(out.str());
+  S21Matrix read = S21ReadCsv(in);
+
+  ASSERT_EQ(read.getRows(), 7);
+  ASSERT_EQ(read.getCols(), 5);
+  EXPECT_TRUE(std::equal(read.begin(), read.end(), first_matrix.begin()));
+  EXPECT_TRUE(S21ParseCsv(out.str()).EqMatrix(first_matrix));
+  EXPECT_TRUE(S21ParseCsv(semicolons.str(), options).EqMatrix(first_matrix));
+
+  S21SaveCsv(path, first_matrix);
+
+  EXPECT_TRUE(S21LoadCsv(path).EqMatrix(first_matrix));
+
+  std::remove(path.c_str());
+
+  ASSERT_THROW(S21LoadCsv(path), std::system_error);
+}
+
+TEST(Csv_suite, shape_test) {
+  std::string text = "\n 1, +2.5 ,-3e2\r\n\n  \n4,5,6\r\n7 ,8,9";
+  std::istringstream in(text);
+  std::istringstream ragged("1,2\n3,4\n5\n");
+
+  S21Matrix first_matrix = S21ParseCsv(text);
+
+  ASSERT_EQ(first_matrix.getRows(), 3);
+  ASSERT_EQ(first_matrix.getCols(), 3);
+  EXPECT_EQ(first_matrix(0, 1), 2.5);
+  EXPECT_EQ(first_matrix(0, 2), -300);
+  EXPECT_EQ(first_matrix(2, 2), 9);
+  EXPECT_TRUE(S21ReadCsv(in).EqMatrix(first_matrix));
+  ASSERT_THROW(S21ParseCsv("1,2\n3\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1,2\n3,4,5\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1,x\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1,,2\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("+-5,1\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1,++5\n"), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv(" \n\n"), std::invalid_argument);
+  ASSERT_THROW(S21ReadCsv(ragged), std::invalid_argument);
+}
+
+TEST(Csv_suite, tab_test) {
+  S21Matrix first_matrix(3, 4);
+  std::ostringstream out;
+  S21CsvOptions options;
+
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      first_matrix(i, j) = i * 2.5 - j / 3.0;
+    }
+  }
+  S21WriteCsv(out, first_matrix, '\t');
+  options.delimiter = '\t';
+  std::istringstream in(out.str());
+
+  EXPECT_TRUE(S21ParseCsv(out.str(), options).EqMatrix(first_matrix));
+  EXPECT_TRUE(S21ReadCsv(in, options).EqMatrix(first_matrix));
+  EXPECT_EQ(S21ParseCsv(" 1\t 2 \t3\r\n", options).getCols(), 3);
+  ASSERT_THROW(S21ParseCsv("1\t\t2\n", options), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1 2\n", options), std::invalid_argument);
+}
+
+TEST(Csv_suite, space_test) {
+  std::string text = "  1   2\t-3\r\n\n4 5    6 \n";
+  S21CsvOptions options;
+
+  options.delimiter = ' ';
+  std::istringstream in(text);
+  S21Matrix first_matrix = S21ParseCsv(text, options);
+
+  ASSERT_EQ(first_matrix.getRows(), 2);
+  ASSERT_EQ(first_matrix.getCols(), 3);
+  EXPECT_EQ(first_matrix(0, 2), -3);
+  EXPECT_EQ(first_matrix(1, 0), 4);
+  EXPECT_EQ(first_matrix(1, 2), 6);
+  EXPECT_TRUE(S21ReadCsv(in, options).EqMatrix(first_matrix));
+  ASSERT_THROW(S21ParseCsv("1 2,3\n", options), std::invalid_argument);
+  ASSERT_THROW(S21ParseCsv("1 2\n3\n", options), std::invalid_argument);
+}
+
+// a stream that cannot seek, like a pipe
+class UnseekableBuffer : public std::streambuf {
+ public:
+  explicit UnseekableBuffer(std::string text) : text_(std::move(text)) {
+    setg(text_.data(), text_.data(), text_.data() + text_.size());
+  }
+
+ private:
+  std::string text_;
+};
+
+TEST(Csv_suite, unseekable_test) {
+  UnseekableBuffer buffer("1,2\n3,4\n\n5,6");
+  UnseekableBuffer ragged("1,2\n3,4,5\n");
+  std::istream in(&buffer);
+  std::istream ragged_in(&ragged);
+
+  S21Matrix first_matrix = S21ReadCsv(in);
+
+  EXPECT_EQ(in.tellg(), std::istream::pos_type(-1));
+  ASSERT_EQ(first_matrix.getRows(), 3);
+  ASSERT_EQ(first_matrix.getCols(), 2);
+  EXPECT_EQ(first_matrix(0, 1), 2);
+  EXPECT_EQ(first_matrix(2, 1), 6);
+  ASSERT_THROW(S21ReadCsv(ragged_in), std::invalid_argument);
+}
+
+TEST(Csv_suite, parallel_test) {
+  S21Matrix first_matrix(60000, 4);
+  std::ostringstream out;
+  S21CsvOptions serial;
+
+  for (int i = 0; i < 60000; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      first_matrix(i, j) = (i * 31 + j * 17) % 1000 / 8.0 - 60;
+    }
+  }
+  S21WriteCsv(out, first_matrix);
+  serial.parallel = false;
+  std::istringstream in(out.str());
+  std::string broken = out.str();
+  broken[broken.size() - 3] = 'x';
+
+  ASSERT_GT(out.str().size(), 1u << 20);
+  EXPECT_TRUE(S21ParseCsv(out.str()).EqMatrix(first_matrix));
+  EXPECT_TRUE(S21ParseCsv(out.str(), serial).EqMatrix(first_matrix));
+  EXPECT_TRUE(S21ReadCsv(in).EqMatrix(first_matrix));
+  try {
+    S21ParseCsv(broken);
+    FAIL();
+  } catch (const std::invalid_argument& error) {
+    EXPECT_STREQ(error.what(), "invalid csv in row 60000");
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,126 @@
+// Times candidate values of the S21TuningConfig parameters on this host and
+// writes the fastest to the file given as the first argument. Each parameter
+// is tuned on its own with the others at their current best, which keeps the
+// whole run at a minute or two.
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "../s21_matrix_oop.h"
+#include "../s21_matrix_tuning.h"
+
+namespace {
+
+constexpr int kRepetitions = 3;
+
+// best of a few runs, in seconds
+double Time(const std::function<void()>& body) {
+  double best = 1e30;
+  for (int i = 0; i < kRepetitions; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+S21Matrix Random(int rows, int cols, unsigned seed) {
+  S21Matrix result(rows, cols, kS21Uninitialized);
+  for (double& x : result) {
+    seed = seed * 1103515245 + 12345;
+    x = (double)(seed >> 16 & 0x7fff) / 0x7fff - 0.5;
+  }
+  return result;
+}
+
+// applies each candidate through set, keeps the fastest and reports it
+template <typename T>
+T Pick(const char* name, const std::vector<T>& candidates,
+       const std::function<void(S21TuningConfig&, T)>& set,
+       const std::function<void()>& body, S21TuningConfig& config) {
+  T best = candidates.front();
+  double best_time = 1e30;
+  for (T candidate : candidates) {
+    set(config, candidate);
+    S21SetTuning(config);
+    double time = Time(body);
+    std::cout << "  " << name << ' ' << candidate << ": " << time * 1e3
+              << " ms\n";
+    if (time < best_time) {
+      best_time = time;
+      best = candidate;
+    }
+  }
+  set(config, best);
+  S21SetTuning(config);
+  std::cout << name << ' ' << best << '\n';
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string path = argc > 1 ? argv[1] : "s21_matrix_tuning.conf";
+  S21TuningConfig config;
+
+  S21Matrix a = Random(640, 640, 1), b = Random(640, 640, 2);
+  auto multiply = [&a, &b]() { S21Matrix c = a * b; };
+  Pick<int>(
+      "gemm_depth_block", {64, 128, 256, 512},
+      [](S21TuningConfig& c, int v) { c.gemm_depth_block = v; }, multiply,
+      config);
+  Pick<int>(
+      "gemm_width_block", {128, 256, 512, 1024},
+      [](S21TuningConfig& c, int v) { c.gemm_width_block = v; }, multiply,
+      config);
+
+  S21Matrix wide = Random(2048, 2048, 3);
+  Pick<int>(
+      "transpose_block", {8, 16, 32, 64, 128},
+      [](S21TuningConfig& c, int v) { c.transpose_block = v; },
+      [&wide]() { S21Matrix t = wide.Transpose(); }, config);
+
+  std::vector<S21Matrix> batch;
+  for (int i = 0; i < 20000; ++i) {
+    batch.push_back(Random(6, 6, i));
+  }
+  Pick<long>(
+      "parallel_grain", {1L << 10, 1L << 13, 1L << 16, 1L << 19},
+      [](S21TuningConfig& c, long v) { c.parallel_grain = v; },
+      [&batch]() { S21Matrix::Determinants(batch); }, config);
+
+  // smallest size at which splitting Sum across threads clearly beats one
+  // thread
+  config.elementwise_parallel_min = S21TuningConfig::kSerialOnly;
+  for (int size = 1 << 14; size <= 1 << 24; size <<= 2) {
+    S21Matrix x = Random(size / 64, 64, 4), y = Random(size / 64, 64, 5);
+    auto sum = [&x, &y]() { x.SumMatrix(y); };
+    S21TuningConfig serial = config, parallel = config;
+    serial.elementwise_parallel_min = S21TuningConfig::kSerialOnly;
+    parallel.elementwise_parallel_min = 0;
+    S21SetTuning(serial);
+    double serial_time = Time(sum);
+    S21SetTuning(parallel);
+    double parallel_time = Time(sum);
+    std::cout << "  elementwise " << size << ": " << serial_time * 1e3
+              << " ms serial, " << parallel_time * 1e3 << " ms parallel\n";
+    if (parallel_time < 0.8 * serial_time) {
+      config.elementwise_parallel_min = size;
+      break;
+    }
+  }
+  std::cout << "elementwise_parallel_min " << config.elementwise_parallel_min
+            << '\n';
+
+  if (!S21SaveTuning(path, config)) {
+    std::cerr << "cannot write " << path << '\n';
+    return 1;
+  }
+  std::cout << "written to " << path << '\n';
+  return 0;
+}
@@ -0,0 +1,246 @@
+#include "s21_matrix_async.h"
+
+#include <algorithm>
+#include <exception>
+#include <system_error>
+
+#include "s21_matrix_kernels.h"
+#include "s21_matrix_solvers.h"
+
+namespace {
+
+constexpr int kRowBlock = 64;
+constexpr int kColumnBlock = 64;
+
+// runs body on the executor and forwards its result or exception
+std::future<S21Matrix> Launch(S21Executor& executor,
+                              std::function<S21Matrix()> body) {
+  auto task = std::make_shared<std::packaged_task<S21Matrix()>>(
+      std::move(body));
+  std::future<S21Matrix> result = task->get_future();
+  executor.Submit([task]() { (*task)(); });
+  return result;
+}
+
+// throws when cancelled, reports progress in [begin, end] otherwise
+std::function<void(double)> MakeCheckpoint(const S21CancellationToken& token,
+                                           const S21ProgressCallback& progress,
+                                           double begin, double end) {
+  return [token, progress, begin, end](double done) {
+    if (token.isCancelled()) throw S21OperationCancelled();
+    if (progress) progress(begin + (end - begin) * done);
+  };
+}
+
+}  // namespace
+
+// S21CancellationToken
+S21CancellationToken::S21CancellationToken()
+    : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+void S21CancellationToken::Cancel() { cancelled_->store(true); }
+
+bool S21CancellationToken::isCancelled() const { return cancelled_->load(); }
+
+// S21OperationCancelled
+S21OperationCancelled::S21OperationCancelled()
+    : std::runtime_error("operation cancelled") {}
+
+// S21Executor
+S21Executor::S21Executor(int threads) : stopping_(false) {
+  if (threads < 1) throw std::out_of_range("invalid number of threads!");
+
+  // threads already started are stopped again when a later one fails
+  try {
+    for (int i = 0; i < threads; ++i) {
+      workers_.emplace_back(&S21Executor::WorkerLoop, this);
+    }
+  } catch (...) {
+    Stop();
+    throw;
+  }
+}
+
+S21Executor::~S21Executor() { Stop(); }
+
+// lets the workers finish the queued tasks and joins them
+void S21Executor::Stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+S21Executor& S21Executor::Default() {
+  static S21Executor executor(
+      std::max(1, (int)std::thread::hardware_concurrency()));
+  return executor;
+}
+
+S21Executor* S21Executor::TryDefault() noexcept {
+  try {
+    return &Default();
+  } catch (const std::system_error&) {
+  } catch (const std::bad_alloc&) {
+  }
+  return nullptr;
+}
+
+int S21Executor::getThreadCount() const { return (int)workers_.size(); }
+
+void S21Executor::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  ready_.notify_one();
+}
+
+void S21Executor::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      ready_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) return;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void S21Executor::ParallelFor(
+    int count, int grain,
+    const std::function<void(const ChunkSource& next)>& worker) {
+  if (count < 1) return;
+  grain = std::max(1, grain);
+  int chunks = (count + grain - 1) / grain;
+
+  // helpers that start after the work ran out leave without touching worker
+  struct State {
+    std::atomic<int> next{0};
+    std::mutex mutex;
+    std::condition_variable idle;
+    int active = 0;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+  ChunkSource next = [state, count, grain](int& begin, int& end) {
+    begin = state->next.fetch_add(grain);
+    if (begin >= count) return false;
+    end = std::min(begin + grain, count);
+    return true;
+  };
+  auto run = [state, count, &next, &worker]() {
+    try {
+      worker(next);
+    } catch (...) {
+      state->next.store(count);
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (!state->error) state->error = std::current_exception();
+    }
+  };
+
+  // a helper that cannot be queued leaves its share to the calling thread
+  int helpers = std::min(getThreadCount(), chunks - 1);
+  for (int i = 0; i < helpers; ++i) {
+    try {
+      Submit([state, count, run]() {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (state->next.load() >= count) return;
+          ++state->active;
+        }
+        run();
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (--state->active == 0) state->idle.notify_all();
+      });
+    } catch (const std::bad_alloc&) {
+      break;
+    }
+  }
+  run();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->idle.wait(lock, [&state]() { return state->active == 0; });
+  if (state->error) std::rethrow_exception(state->error);
+}
+
+void S21ParallelFor(
+    int count, int grain,
+    const std::function<void(const S21Executor::ChunkSource& next)>& worker) {
+  if (S21Executor* executor = S21Executor::TryDefault()) {
+    executor->ParallelFor(count, grain, worker);
+    return;
+  }
+  grain = std::max(1, grain);
+  int position = 0;
+  worker([&position, count, grain](int& begin, int& end) {
+    if (position >= count) return false;
+    begin = position;
+    end = std::min(position + grain, count);
+    position = end;
+    return true;
+  });
+}
+
+// operations
+std::future<S21Matrix> MulMatrixAsync(const S21Matrix& a, const S21Matrix& b,
+                                      S21CancellationToken token,
+                                      S21ProgressCallback progress,
+                                      S21Executor& executor) {
+  return Launch(executor, [a, b, token, progress]() {
+    if (a.getCols() != b.getRows() || a.getRows() < 1 || b.getCols() < 1)
+      throw std::logic_error("invalid size of matrix!");
+
+    auto checkpoint = MakeCheckpoint(token, progress, 0, 1);
+    int rows = a.getRows();
+    S21Matrix result(rows, b.getCols(), kS21Uninitialized);
+    for (int i = 0; i < rows; i += kRowBlock) {
+      checkpoint((double)i / rows);
+      s21_kernels::Gemm(a.Data(), b.Data(), result.Data(), a.getCols(),
+                        b.getCols(), i, std::min(i + kRowBlock, rows));
+    }
+    checkpoint(1);
+    return result;
+  });
+}
+
+std::future<S21Matrix> InverseMatrixAsync(const S21Matrix& a,
+                                          S21CancellationToken token,
+                                          S21ProgressCallback progress,
+                                          S21Executor& executor) {
+  return Launch(executor, [a, token, progress]() {
+    if (a.getRows() != a.getCols() || a.getRows() < 1)
+      throw std::invalid_argument("invalid size of matrix!");
+
+    // the factorization is about a third of the flops of an inversion
+    int n = a.getRows();
+    S21LU lu(a, MakeCheckpoint(token, progress, 0, 1.0 / 3));
+    // decided as in InverseMatrix(), by the eliminated determinant
+    if (lu.isSingular() || fabs(a.Determinant()) < 1e-7)
+      throw std::invalid_argument("invalid matrix!");
+
+    auto checkpoint = MakeCheckpoint(token, progress, 1.0 / 3, 1);
+    S21Matrix result(n, n, kS21Uninitialized);
+    for (int j = 0; j < n; j += kColumnBlock) {
+      checkpoint((double)j / n);
+      int width = std::min(kColumnBlock, n - j);
+      S21Matrix unit(n, width);
+      for (int c = 0; c < width; ++c) {
+        unit.At(j + c, c) = 1;
+      }
+      S21Matrix block = lu.Solve(unit);
+      for (int i = 0; i < n; ++i) {
+        std::copy_n(block.Row(i).begin(), width, result.Row(i).begin() + j);
+      }
+    }
+    checkpoint(1);
+    return result;
+  });
+}
@@ -0,0 +1,93 @@
+#ifndef S21_MATRIX_S21MATRIX_ASYNC_H
+#define S21_MATRIX_S21MATRIX_ASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// called from the worker thread with the completed fraction in [0, 1]
+using S21ProgressCallback = std::function<void(double)>;
+
+// shared flag; copies of a token observe the same cancellation
+class S21CancellationToken {
+ public:
+  S21CancellationToken();
+
+  void Cancel();
+  bool isCancelled() const;
+
+ private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+// stored in the future of an operation whose token was cancelled
+class S21OperationCancelled : public std::runtime_error {
+ public:
+  S21OperationCancelled();
+};
+
+// fixed-size pool of worker threads running submitted tasks in FIFO order
+class S21Executor {
+ public:
+  explicit S21Executor(int threads);
+  S21Executor(const S21Executor&) = delete;
+  S21Executor& operator=(const S21Executor&) = delete;
+  ~S21Executor();
+
+  // library-wide pool with one thread per hardware thread
+  static S21Executor& Default();
+  // Default(), or null when its threads cannot be started
+  static S21Executor* TryDefault() noexcept;
+
+  int getThreadCount() const;
+  void Submit(std::function<void()> task);
+
+  // Splits [0, count) into chunks of grain indices and runs worker on the
+  // calling thread and on idle pool threads. A worker calls next(begin, end)
+  // until it returns false, so its scratch buffers live across chunks. Blocks
+  // until every chunk is done and rethrows the first exception of a worker;
+  // safe to call from a pool thread.
+  using ChunkSource = std::function<bool(int& begin, int& end)>;
+  void ParallelFor(int count, int grain,
+                   const std::function<void(const ChunkSource& next)>& worker);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> workers_;
+  bool stopping_;
+
+  void WorkerLoop();
+  void Stop() noexcept;
+};
+
+// ParallelFor on the default executor, or on the calling thread alone when
+// the default executor cannot be started
+void S21ParallelFor(
+    int count, int grain,
+    const std::function<void(const S21Executor::ChunkSource& next)>& worker);
+
+// The operands are copied, so they may change or be destroyed while the
+// operation runs. Cancellation and progress are checked between blocks of
+// rows (multiplication) or pivot columns (inversion).
+std::future<S21Matrix> MulMatrixAsync(
+    const S21Matrix& a, const S21Matrix& b,
+    S21CancellationToken token = S21CancellationToken(),
+    S21ProgressCallback progress = nullptr,
+    S21Executor& executor = S21Executor::Default());
+std::future<S21Matrix> InverseMatrixAsync(
+    const S21Matrix& a, S21CancellationToken token = S21CancellationToken(),
+    S21ProgressCallback progress = nullptr,
+    S21Executor& executor = S21Executor::Default());
+
+#endif  // S21_MATRIX_S21MATRIX_ASYNC_H
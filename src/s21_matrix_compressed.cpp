@@ -0,0 +1,223 @@
+#include "s21_matrix_compressed.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// round to nearest even, see F. Giesen, "float->half variants"
+std::uint16_t FloatToHalf(float value) {
+  constexpr std::uint32_t kInfinity = 255u << 23;
+  constexpr std::uint32_t kHalfOverflow = (127u + 16) << 23;
+  constexpr std::uint32_t kDenormalMagic = ((127u - 15) + (23 - 10) + 1) << 23;
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  std::uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  std::uint16_t result;
+  if (bits >= kHalfOverflow) {
+    result = bits > kInfinity ? 0x7e00 : 0x7c00;
+  } else if (bits < (113u << 23)) {
+    // the float addition rounds the mantissa into denormal position
+    float shifted = std::bit_cast<float>(bits) +
+                    std::bit_cast<float>(kDenormalMagic);
+    result = (std::uint16_t)(std::bit_cast<std::uint32_t>(shifted) -
+                             kDenormalMagic);
+  } else {
+    std::uint32_t odd = (bits >> 13) & 1;
+    bits += ((15u - 127) << 23) + 0xfff + odd;
+    result = (std::uint16_t)(bits >> 13);
+  }
+  return result | (std::uint16_t)(sign >> 16);
+}
+
+float HalfToFloat(std::uint16_t half) {
+  constexpr std::uint32_t kShiftedExponent = 0x7c00u << 13;
+  std::uint32_t bits = (half & 0x7fffu) << 13;
+  std::uint32_t exponent = bits & kShiftedExponent;
+  bits += (127u - 15) << 23;
+  if (exponent == kShiftedExponent) {
+    bits += (128u - 16) << 23;  // infinity or nan
+  } else if (exponent == 0) {
+    bits += 1u << 23;  // denormal, renormalized by the subtraction
+    bits = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) -
+                                        std::bit_cast<float>(113u << 23));
+  }
+  return std::bit_cast<float>(bits | (std::uint32_t)(half & 0x8000u) << 16);
+}
+
+std::uint16_t FloatToBFloat(float value) {
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  if ((bits & 0x7fffffffu) > 0x7f800000u) return (bits >> 16) | 0x40;
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return (std::uint16_t)(bits >> 16);
+}
+
+float BFloatToFloat(std::uint16_t half) {
+  return std::bit_cast<float>((std::uint32_t)half << 16);
+}
+
+// c = a * b for a m x k matrix given row by row: row(i) returns a callable
+// that widens element (i, p)
+template <typename RowDecoder>
+void Multiply(const RowDecoder& row, int m, int k, int n, const double* b,
+              double* c) {
+  for (int i = 0; i < m; ++i) {
+    auto a = row(i);
+    double* out = c + i * n;
+    std::fill(out, out + n, 0.0);
+    for (int p = 0; p < k; ++p) {
+      double factor = a(p);
+      const double* b_row = b + p * n;
+      for (int j = 0; j < n; ++j) {
+        out[j] += factor * b_row[j];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+S21CompressedMatrix::S21CompressedMatrix(const S21Matrix& m,
+                                         S21Precision precision)
+    : rows_(m.getRows()), cols_(m.getCols()), precision_(precision) {
+  if (rows_ < 1 || cols_ < 1) throw std::out_of_range("invalid length!");
+
+  const double* data = m.Data();
+  std::size_t size = (std::size_t)rows_ * cols_;
+  switch (precision_) {
+    case S21Precision::kFloat16:
+      halves_.resize(size);
+      std::transform(data, data + size, halves_.begin(),
+                     [](double x) { return FloatToHalf((float)x); });
+      break;
+    case S21Precision::kBFloat16:
+      halves_.resize(size);
+      std::transform(data, data + size, halves_.begin(),
+                     [](double x) { return FloatToBFloat((float)x); });
+      break;
+    case S21Precision::kInt8:
+      quantized_.resize(size);
+      scales_.resize(rows_);
+      for (int i = 0; i < rows_; ++i) {
+        const double* row = data + i * cols_;
+        double max = 0;
+        for (int j = 0; j < cols_; ++j) {
+          max = std::max(max, fabs(row[j]));
+        }
+        scales_[i] = max / 127;
+        for (int j = 0; j < cols_; ++j) {
+          quantized_[i * cols_ + j] =
+              max > 0 ? (std::int8_t)lround(row[j] / scales_[i]) : 0;
+        }
+      }
+      break;
+  }
+}
+
+// accessors
+int S21CompressedMatrix::getRows() const { return rows_; }
+int S21CompressedMatrix::getCols() const { return cols_; }
+S21Precision S21CompressedMatrix::getPrecision() const { return precision_; }
+
+std::size_t S21CompressedMatrix::getBytes() const {
+  return halves_.size() * sizeof(std::uint16_t) + quantized_.size() +
+         scales_.size() * sizeof(double);
+}
+
+// operations
+double S21CompressedMatrix::operator()(int row, int col) const {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+    throw std::out_of_range("index is out of range");
+  int index = row * cols_ + col;
+  switch (precision_) {
+    case S21Precision::kFloat16:
+      return HalfToFloat(halves_[index]);
+    case S21Precision::kBFloat16:
+      return BFloatToFloat(halves_[index]);
+    case S21Precision::kInt8:
+      break;
+  }
+  return scales_[row] * quantized_[index];
+}
+
+S21Matrix S21CompressedMatrix::Decompress() const {
+  S21Matrix result(rows_, cols_, kS21Uninitialized);
+  double* out = result.Data();
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < cols_; ++j) {
+      out[i * cols_ + j] = (*this)(i, j);
+    }
+  }
+  return result;
+}
+
+S21Matrix S21CompressedMatrix::MulMatrix(const S21Matrix& b) const {
+  if (cols_ != b.getRows()) throw std::logic_error("invalid size of matrix!");
+
+  S21Matrix result(rows_, b.getCols(), kS21Uninitialized);
+  int n = b.getCols();
+  const double* b_data = b.Data();
+  double* c = result.Data();
+  switch (precision_) {
+    case S21Precision::kFloat16:
+      Multiply(
+          [this](int i) {
+            const std::uint16_t* row = halves_.data() + i * cols_;
+            return [row](int p) { return (double)HalfToFloat(row[p]); };
+          },
+          rows_, cols_, n, b_data, c);
+      break;
+    case S21Precision::kBFloat16:
+      Multiply(
+          [this](int i) {
+            const std::uint16_t* row = halves_.data() + i * cols_;
+            return [row](int p) { return (double)BFloatToFloat(row[p]); };
+          },
+          rows_, cols_, n, b_data, c);
+      break;
+    case S21Precision::kInt8:
+      Multiply(
+          [this](int i) {
+            const std::int8_t* row = quantized_.data() + i * cols_;
+            double scale = scales_[i];
+            return [row, scale](int p) { return scale * row[p]; };
+          },
+          rows_, cols_, n, b_data, c);
+      break;
+  }
+  return result;
+}
+
+std::vector<double> S21CompressedMatrix::MulVector(
+    const std::vector<double>& x) const {
+  if ((int)x.size() != cols_) throw std::logic_error("invalid size of matrix!");
+
+  std::vector<double> result(rows_);
+  for (int i = 0; i < rows_; ++i) {
+    double sum = 0;
+    switch (precision_) {
+      case S21Precision::kFloat16:
+        for (int p = 0; p < cols_; ++p) {
+          sum += HalfToFloat(halves_[i * cols_ + p]) * x[p];
+        }
+        break;
+      case S21Precision::kBFloat16:
+        for (int p = 0; p < cols_; ++p) {
+          sum += BFloatToFloat(halves_[i * cols_ + p]) * x[p];
+        }
+        break;
+      case S21Precision::kInt8:
+        // the row scale factors out of the sum
+        for (int p = 0; p < cols_; ++p) {
+          sum += quantized_[i * cols_ + p] * x[p];
+        }
+        sum *= scales_[i];
+        break;
+    }
+    result[i] = sum;
+  }
+  return result;
+}
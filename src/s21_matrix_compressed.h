@@ -0,0 +1,40 @@
+#ifndef S21_MATRIX_S21MATRIX_COMPRESSED_H
+#define S21_MATRIX_S21MATRIX_COMPRESSED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// kInt8 keeps one scale per row, element = scale * q with q in [-127, 127]
+enum class S21Precision { kFloat16, kBFloat16, kInt8 };
+
+// Read-only copy of a matrix in 2 (fp16, bf16) or 1 (int8) byte elements.
+// Products widen each element to double as it is loaded, so nothing is
+// decompressed up front. Values outside the fp16 range become infinities.
+class S21CompressedMatrix {
+ public:
+  S21CompressedMatrix(const S21Matrix& m, S21Precision precision);
+
+  // accessors
+  int getRows() const;
+  int getCols() const;
+  S21Precision getPrecision() const;
+  std::size_t getBytes() const;
+
+  // operations
+  double operator()(int row, int col) const;
+  S21Matrix Decompress() const;
+  S21Matrix MulMatrix(const S21Matrix& b) const;
+  std::vector<double> MulVector(const std::vector<double>& x) const;
+
+ private:
+  int rows_, cols_;
+  S21Precision precision_;
+  std::vector<std::uint16_t> halves_;
+  std::vector<std::int8_t> quantized_;
+  std::vector<double> scales_;
+};
+
+#endif  // S21_MATRIX_S21MATRIX_COMPRESSED_H
@@ -0,0 +1,312 @@
+#include "s21_matrix_csv.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include "s21_matrix_async.h"
+
+namespace {
+
+constexpr std::size_t kStreamChunk = 1 << 20;
+constexpr std::size_t kParallelChunk = 1 << 20;
+
+// blanks around fields are skipped; a tab delimiter is not a blank, a space
+// delimiter is, and then any run of blanks separates fields
+bool IsBlank(char c, char delimiter) {
+  return (c == ' ' || c == '\t' || c == '\r') && (c != delimiter || c == ' ');
+}
+
+bool IsBlankLine(const char* p, const char* end, char delimiter) {
+  return std::all_of(p, end, [delimiter](char c) {
+    return IsBlank(c, delimiter);
+  });
+}
+
+[[noreturn]] void ThrowInvalidRow(long long row) {
+  throw std::invalid_argument("invalid csv in row " + std::to_string(row));
+}
+
+// fields of the line [p, end) into out, which has room for cols values, or
+// only counted when out is null; -1 when a field is not a number or there
+// are more than cols
+int ParseLine(const char* p, const char* end, char delimiter, double* out,
+              int cols) {
+  auto skip = [end, delimiter](const char* at) {
+    while (at < end && IsBlank(*at, delimiter)) ++at;
+    return at;
+  };
+  bool blank_delimiter = IsBlank(delimiter, delimiter);
+  int count = 0;
+  p = skip(p);
+  while (true) {
+    // from_chars takes no '+', and after one it must not find another sign
+    if (p < end && *p == '+') {
+      ++p;
+      if (p < end && (*p == '+' || *p == '-')) return -1;
+    }
+    double value;
+    auto [next, error] = std::from_chars(p, end, value);
+    if (error != std::errc() || count == cols) return -1;
+    if (out) out[count] = value;
+    ++count;
+    p = skip(next);
+    if (p == end) return count;
+    if (blank_delimiter) {
+      if (p == next) return -1;
+    } else {
+      if (*p != delimiter) return -1;
+      p = skip(p + 1);
+    }
+  }
+}
+
+// calls on_line(begin, end) for every non-blank line of [p, end) and returns
+// the position after the last complete line; a trailing line without a
+// newline is included when last is set
+template <typename OnLine>
+const char* ForEachLine(const char* p, const char* end, bool last,
+                        char delimiter, const OnLine& on_line) {
+  while (p < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(p, '\n', end - p));
+    if (!newline && !last) break;
+    const char* line_end = newline ? newline : end;
+    if (!IsBlankLine(p, line_end, delimiter)) on_line(p, line_end);
+    p = newline ? newline + 1 : end;
+  }
+  return p;
+}
+
+// ForEachLine over in, read in fixed-size chunks; an incomplete last line is
+// carried over to the next chunk
+template <typename OnLine>
+void ForEachStreamLine(std::istream& in, char delimiter,
+                       const OnLine& on_line) {
+  std::vector<char> buffer;
+  std::size_t carried = 0;
+  while (in) {
+    buffer.resize(carried + kStreamChunk);
+    in.read(buffer.data() + carried, kStreamChunk);
+    std::size_t size = carried + (std::size_t)in.gcount();
+    const char* rest = ForEachLine(buffer.data(), buffer.data() + size, !in,
+                                   delimiter, on_line);
+    carried = buffer.data() + size - rest;
+    std::copy(rest, rest + carried, buffer.begin());
+  }
+}
+
+void CheckShape(long long rows, int cols) {
+  if (rows == 0) throw std::invalid_argument("invalid csv: no rows");
+  if (rows > INT_MAX / cols)
+    throw std::invalid_argument("invalid csv: too many rows");
+}
+
+// number of fields of the first non-blank line
+int InferColumns(const char* p, const char* end, char delimiter) {
+  int cols = 0;
+  while (p < end && cols == 0) {
+    const char* newline =
+        static_cast<const char*>(memchr(p, '\n', end - p));
+    const char* line_end = newline ? newline : end;
+    if (!IsBlankLine(p, line_end, delimiter)) {
+      cols = ParseLine(p, line_end, delimiter, nullptr, INT_MAX);
+      if (cols < 1) ThrowInvalidRow(1);
+    }
+    p = newline ? newline + 1 : end;
+  }
+  return cols;
+}
+
+// closes and unmaps a loaded file
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::system_error(errno, std::generic_category(), path);
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+      size_ = (std::size_t)info.st_size;
+      if (size_ > 0)
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    int error = errno;
+    close(fd);
+    if (data_ == MAP_FAILED)
+      throw std::system_error(error, std::generic_category(), path);
+    if (data_) madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (data_) munmap(data_, size_);
+  }
+
+  std::string_view Text() const {
+    return data_ ? std::string_view(static_cast<const char*>(data_), size_)
+                 : std::string_view();
+  }
+
+ private:
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace
+
+// two passes over line-aligned chunks: count the rows of each, then parse
+// every chunk straight into its rows of the result
+S21Matrix S21ParseCsv(std::string_view text, const S21CsvOptions& options) {
+  const char* begin = text.data();
+  const char* end = begin + text.size();
+  char delimiter = options.delimiter;
+  int cols = InferColumns(begin, end, delimiter);
+  if (cols == 0) throw std::invalid_argument("invalid csv: no rows");
+
+  S21Executor* executor = S21Executor::TryDefault();
+  std::size_t step = text.size();
+  if (options.parallel && executor) {
+    step = std::max(kParallelChunk,
+                    text.size() / (4 * executor->getThreadCount()) + 1);
+  }
+  std::vector<const char*> bounds = {begin};
+  while (bounds.back() < end) {
+    const char* p =
+        bounds.back() + std::min(step, (std::size_t)(end - bounds.back()));
+    const char* newline =
+        p < end ? static_cast<const char*>(memchr(p, '\n', end - p)) : nullptr;
+    bounds.push_back(newline ? newline + 1 : end);
+  }
+  int chunks = (int)bounds.size() - 1;
+
+  std::vector<long long> first_row(chunks + 1, 0);
+  S21ParallelFor(chunks, 1, [&](const S21Executor::ChunkSource& next) {
+    int begin_chunk, end_chunk;
+    while (next(begin_chunk, end_chunk)) {
+      for (int chunk = begin_chunk; chunk < end_chunk; ++chunk) {
+        long long rows = 0;
+        ForEachLine(bounds[chunk], bounds[chunk + 1], true, delimiter,
+                    [&rows](const char*, const char*) { ++rows; });
+        first_row[chunk + 1] = rows;
+      }
+    }
+  });
+  for (int c = 0; c < chunks; ++c) {
+    first_row[c + 1] += first_row[c];
+  }
+  CheckShape(first_row[chunks], cols);
+
+  S21Matrix result((int)first_row[chunks], cols, kS21Uninitialized);
+  double* data = result.Data();
+  S21ParallelFor(chunks, 1, [&](const S21Executor::ChunkSource& next) {
+    int begin_chunk, end_chunk;
+    while (next(begin_chunk, end_chunk)) {
+      long long row = first_row[begin_chunk];
+      ForEachLine(bounds[begin_chunk], bounds[end_chunk], true, delimiter,
+                  [&](const char* line, const char* line_end) {
+                    if (ParseLine(line, line_end, delimiter, data + row * cols,
+                                  cols) != cols)
+                      ThrowInvalidRow(row + 1);
+                    ++row;
+                  });
+    }
+  });
+  return result;
+}
+
+// a seekable stream is read twice, once for the shape and once parsing
+// straight into the result; other streams are collected first
+S21Matrix S21ReadCsv(std::istream& in, const S21CsvOptions& options) {
+  char delimiter = options.delimiter;
+  int cols = 0;
+  long long rows = 0;
+  auto infer = [&](const char* line, const char* line_end) {
+    if (cols == 0) {
+      cols = ParseLine(line, line_end, delimiter, nullptr, INT_MAX);
+      if (cols < 1) ThrowInvalidRow(1);
+    }
+  };
+
+  std::istream::pos_type start = in.tellg();
+  if (start != std::istream::pos_type(-1)) {
+    ForEachStreamLine(in, delimiter, [&](const char* line, const char* end) {
+      infer(line, end);
+      ++rows;
+    });
+    CheckShape(rows, cols);
+    in.clear();
+    if (!in.seekg(start))
+      throw std::ios_base::failure("cannot rewind the csv stream");
+
+    S21Matrix result((int)rows, cols, kS21Uninitialized);
+    double* data = result.Data();
+    long long row = 0;
+    ForEachStreamLine(in, delimiter, [&](const char* line, const char* end) {
+      if (row == rows ||
+          ParseLine(line, end, delimiter, data + row * cols, cols) != cols)
+        ThrowInvalidRow(row + 1);
+      ++row;
+    });
+    if (row != rows) ThrowInvalidRow(row + 1);
+    return result;
+  }
+
+  std::vector<double> values;
+  ForEachStreamLine(in, delimiter, [&](const char* line, const char* end) {
+    infer(line, end);
+    values.resize(values.size() + cols);
+    if (ParseLine(line, end, delimiter, values.data() + rows * cols, cols) !=
+        cols)
+      ThrowInvalidRow(rows + 1);
+    ++rows;
+  });
+  CheckShape(rows, cols);
+
+  S21Matrix result((int)rows, cols, kS21Uninitialized);
+  std::copy(values.begin(), values.end(), result.Data());
+  return result;
+}
+
+S21Matrix S21LoadCsv(const std::string& path, const S21CsvOptions& options) {
+  MappedFile file(path);
+  return S21ParseCsv(file.Text(), options);
+}
+
+void S21WriteCsv(std::ostream& out, const S21Matrix& m, char delimiter) {
+  // a double takes at most 24 characters in shortest form
+  constexpr std::size_t kBuffer = 1 << 16, kField = 32;
+  std::vector<char> buffer(kBuffer);
+  char* p = buffer.data();
+  char* limit = buffer.data() + kBuffer - kField;
+  const double* data = m.Data();
+  int rows = m.getRows(), cols = m.getCols();
+  for (int i = 0; i < rows; ++i) {
+    for (int j = 0; j < cols; ++j) {
+      p = std::to_chars(p, p + kField, data[i * cols + j]).ptr;
+      *p++ = j + 1 < cols ? delimiter : '\n';
+      if (p > limit) {
+        out.write(buffer.data(), p - buffer.data());
+        p = buffer.data();
+      }
+    }
+  }
+  out.write(buffer.data(), p - buffer.data());
+}
+
+void S21SaveCsv(const std::string& path, const S21Matrix& m, char delimiter) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) throw std::system_error(errno, std::generic_category(), path);
+  S21WriteCsv(file, m, delimiter);
+  if (!file.flush())
+    throw std::system_error(errno, std::generic_category(), path);
+}
@@ -0,0 +1,38 @@
+#ifndef S21_MATRIX_S21MATRIX_CSV_H
+#define S21_MATRIX_S21MATRIX_CSV_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "s21_matrix_oop.h"
+
+struct S21CsvOptions {
+  char delimiter = ',';
+  // large inputs are split into line-aligned chunks parsed on the default
+  // executor; applies to S21ParseCsv and S21LoadCsv
+  bool parallel = true;
+};
+
+// Locale-independent CSV of numbers, one matrix row per line. The shape is
+// inferred: every non-blank line is a row and all rows must have as many
+// fields as the first. Spaces and tabs around fields and \r\n line ends are
+// accepted; with a space delimiter any run of them separates fields.
+// Malformed input throws std::invalid_argument naming the row, files that
+// cannot be opened throw std::system_error.
+S21Matrix S21ParseCsv(std::string_view text, const S21CsvOptions& options = {});
+// reads the stream in fixed-size chunks instead of holding the whole text;
+// a seekable stream is read twice and parsed straight into the result, any
+// other stream has its values collected before the matrix is allocated
+S21Matrix S21ReadCsv(std::istream& in, const S21CsvOptions& options = {});
+// maps the file and parses it in place
+S21Matrix S21LoadCsv(const std::string& path,
+                     const S21CsvOptions& options = {});
+
+// shortest representation that reads back to the same double
+void S21WriteCsv(std::ostream& out, const S21Matrix& m, char delimiter = ',');
+void S21SaveCsv(const std::string& path, const S21Matrix& m,
+                char delimiter = ',');
+
+#endif  // S21_MATRIX_S21MATRIX_CSV_H
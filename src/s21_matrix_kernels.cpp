@@ -0,0 +1,161 @@
+#include "s21_matrix_kernels.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "s21_matrix_tuning.h"
+
+namespace s21_kernels {
+
+namespace {
+
+// rows of a kept in cache while a block of c rows is updated from them
+constexpr int kSyrkPanel = 256;
+constexpr int kSyrkBlock = 64;
+// columns of x solved together
+constexpr int kTrsmWidth = 256;
+
+}  // namespace
+
+// a k-block of b rows and a j-block of c columns stay in L2 while the rows of
+// a stream through
+void Gemm(const double* a, const double* b, double* c, int k, int n,
+          int row_begin, int row_end) {
+  const S21TuningConfig& tuning = S21Tuning();
+  int depth_block = tuning.gemm_depth_block;
+  int width_block = tuning.gemm_width_block;
+  for (int kk = 0; kk < k; kk += depth_block) {
+    int k_end = std::min(kk + depth_block, k);
+    for (int jj = 0; jj < n; jj += width_block) {
+      int j_end = std::min(jj + width_block, n);
+      for (int i = row_begin; i < row_end; ++i) {
+        double* out = c + i * n;
+        for (int p = kk; p < k_end; ++p) {
+          double factor = a[i * k + p];
+          const double* row = b + p * n;
+          if (p == 0) {
+            for (int j = jj; j < j_end; ++j) {
+              out[j] = factor * row[j];
+            }
+          } else {
+            for (int j = jj; j < j_end; ++j) {
+              out[j] += factor * row[j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+double Determinant(double* a, double** rows, int n) {
+  if (n == 0) return 0;
+  for (int i = 0; i < n; ++i) {
+    rows[i] = a + i * n;
+  }
+  double prev = 1;
+  int sign = 1;
+  for (int k = 0; k < n - 1; ++k) {
+    int pivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (fabs(rows[i][k]) > fabs(rows[pivot][k])) pivot = i;
+    }
+    if (rows[pivot][k] == 0) return 0;
+    if (pivot != k) {
+      std::swap(rows[pivot], rows[k]);
+      sign = -sign;
+    }
+    for (int i = k + 1; i < n; ++i) {
+      for (int j = k + 1; j < n; ++j) {
+        rows[i][j] = (rows[i][j] * rows[k][k] - rows[i][k] * rows[k][j]) / prev;
+      }
+    }
+    prev = rows[k][k];
+  }
+  return sign * rows[n - 1][n - 1];
+}
+
+bool Trsm(const double* t, double* x, int n, int nrhs, bool lower,
+          bool unit_diagonal) {
+  for (int i = 0; i < n; ++i) {
+    if (!unit_diagonal && t[i * n + i] == 0) return false;
+  }
+  for (int jj = 0; jj < nrhs; jj += kTrsmWidth) {
+    int j_end = std::min(jj + kTrsmWidth, nrhs);
+    for (int step = 0; step < n; ++step) {
+      int i = lower ? step : n - 1 - step;
+      double* x_i = x + i * nrhs;
+      int k_begin = lower ? 0 : i + 1, k_end = lower ? i : n;
+      for (int k = k_begin; k < k_end; ++k) {
+        double factor = t[i * n + k];
+        if (factor == 0) continue;
+        const double* x_k = x + k * nrhs;
+        for (int j = jj; j < j_end; ++j) {
+          x_i[j] -= factor * x_k[j];
+        }
+      }
+      if (!unit_diagonal) {
+        double pivot = t[i * n + i];
+        for (int j = jj; j < j_end; ++j) {
+          x_i[j] /= pivot;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void SyrkTransposed(const double* a, double* c, int rows, int cols) {
+  for (int i = 0; i < cols; ++i) {
+    std::fill(c + i * cols, c + i * cols + i + 1, 0.0);
+  }
+  for (int rr = 0; rr < rows; rr += kSyrkPanel) {
+    int r_end = std::min(rr + kSyrkPanel, rows);
+    for (int ii = 0; ii < cols; ii += kSyrkBlock) {
+      int i_end = std::min(ii + kSyrkBlock, cols);
+      for (int r = rr; r < r_end; ++r) {
+        const double* row = a + (std::size_t)r * cols;
+        for (int i = ii; i < i_end; ++i) {
+          double factor = row[i];
+          double* out = c + i * cols;
+          for (int j = 0; j <= i; ++j) {
+            out[j] += factor * row[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+void Syrk(const double* a, double* c, int rows, int cols) {
+  for (int ii = 0; ii < rows; ii += kSyrkBlock) {
+    int i_end = std::min(ii + kSyrkBlock, rows);
+    for (int jj = 0; jj <= ii; jj += kSyrkBlock) {
+      for (int i = ii; i < i_end; ++i) {
+        const double* a_i = a + (std::size_t)i * cols;
+        int j_end = std::min(jj + kSyrkBlock, i + 1);
+        for (int j = jj; j < j_end; ++j) {
+          const double* a_j = a + (std::size_t)j * cols;
+          // independent partial sums keep the adds pipelined
+          double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+          int k = 0;
+          for (; k + 4 <= cols; k += 4) {
+            s0 += a_i[k] * a_j[k];
+            s1 += a_i[k + 1] * a_j[k + 1];
+            s2 += a_i[k + 2] * a_j[k + 2];
+            s3 += a_i[k + 3] * a_j[k + 3];
+          }
+          for (; k < cols; ++k) {
+            s0 += a_i[k] * a_j[k];
+          }
+          c[i * rows + j] = (s0 + s1) + (s2 + s3);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace s21_kernels
@@ -0,0 +1,32 @@
+#ifndef S21_MATRIX_S21MATRIX_KERNELS_H
+#define S21_MATRIX_S21MATRIX_KERNELS_H
+
+// Raw loops over contiguous row-major buffers shared by S21Matrix and the
+// helper classes built on top of it.
+namespace s21_kernels {
+
+// c[row_begin..row_end) = a * b, where a is m x k, b is k x n, c is m x n;
+// the previous contents of those rows of c are never read
+void Gemm(const double* a, const double* b, double* c, int k, int n,
+          int row_begin, int row_end);
+
+// determinant of the n x n matrix in a by fraction-free (Bareiss)
+// elimination, exact for integer entries; a is destroyed and rows must have
+// room for n pointers
+double Determinant(double* a, double** rows, int n);
+
+// solves t * x = b in place of the n x nrhs matrix x using only the lower or
+// upper triangle of the n x n matrix t, whose diagonal is taken as ones when
+// unit_diagonal is set; false on a zero pivot, with x partly overwritten
+bool Trsm(const double* t, double* x, int n, int nrhs, bool lower,
+          bool unit_diagonal);
+
+// lower triangle of c = a^T * a (cols x cols) for a rows x cols matrix a,
+// streaming a once per panel of rows; the upper triangle is left untouched
+void SyrkTransposed(const double* a, double* c, int rows, int cols);
+// lower triangle of c = a * a^T (rows x rows)
+void Syrk(const double* a, double* c, int rows, int cols);
+
+}  // namespace s21_kernels
+
+#endif  // S21_MATRIX_S21MATRIX_KERNELS_H
@@ -0,0 +1,91 @@
+#include "s21_matrix_memory.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace {
+
+std::atomic<std::size_t> live_bytes{0};
+std::atomic<std::size_t> peak_bytes{0};
+std::atomic<std::size_t> budget_bytes{0};
+
+// per thread: totals, allocated minus freed, and the highest value of the
+// latter since the innermost scope started
+thread_local std::size_t thread_allocated = 0;
+thread_local std::size_t thread_freed = 0;
+thread_local long long thread_net = 0;
+thread_local long long thread_peak = 0;
+
+}  // namespace
+
+// S21MemoryBudgetExceeded
+S21MemoryBudgetExceeded::S21MemoryBudgetExceeded(std::size_t requested,
+                                                 std::size_t budget)
+    : requested_(requested), budget_(budget) {}
+
+const char* S21MemoryBudgetExceeded::what() const noexcept {
+  return "matrix memory budget exceeded";
+}
+
+std::size_t S21MemoryBudgetExceeded::getRequested() const {
+  return requested_;
+}
+std::size_t S21MemoryBudgetExceeded::getBudget() const { return budget_; }
+
+// S21MemoryTracker
+std::size_t S21MemoryTracker::getLiveBytes() { return live_bytes.load(); }
+std::size_t S21MemoryTracker::getPeakBytes() { return peak_bytes.load(); }
+void S21MemoryTracker::ResetPeak() { peak_bytes.store(live_bytes.load()); }
+std::size_t S21MemoryTracker::getBudget() { return budget_bytes.load(); }
+void S21MemoryTracker::setBudget(std::size_t bytes) {
+  budget_bytes.store(bytes);
+}
+
+void S21MemoryTracker::Reserve(std::size_t bytes) {
+  std::size_t budget = budget_bytes.load(std::memory_order_relaxed);
+  std::size_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+                     bytes;
+  if (budget && live > budget) {
+    live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    throw S21MemoryBudgetExceeded(bytes, budget);
+  }
+  std::size_t peak = peak_bytes.load(std::memory_order_relaxed);
+  while (peak < live && !peak_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+
+  thread_allocated += bytes;
+  thread_net += (long long)bytes;
+  thread_peak = std::max(thread_peak, thread_net);
+}
+
+void S21MemoryTracker::Release(std::size_t bytes) noexcept {
+  live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  thread_freed += bytes;
+  thread_net -= (long long)bytes;
+}
+
+// S21MemoryScope
+S21MemoryScope::S21MemoryScope()
+    : allocated_(thread_allocated),
+      freed_(thread_freed),
+      base_(thread_net),
+      outer_peak_(thread_peak) {
+  thread_peak = thread_net;
+}
+
+S21MemoryScope::~S21MemoryScope() {
+  thread_peak = std::max(outer_peak_, thread_peak);
+}
+
+std::size_t S21MemoryScope::getAllocatedBytes() const {
+  return thread_allocated - allocated_;
+}
+
+std::size_t S21MemoryScope::getFreedBytes() const {
+  return thread_freed - freed_;
+}
+
+std::size_t S21MemoryScope::getPeakBytes() const {
+  return (std::size_t)(thread_peak - base_);
+}
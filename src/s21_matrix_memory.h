@@ -0,0 +1,58 @@
+#ifndef S21_MATRIX_S21MATRIX_MEMORY_H
+#define S21_MATRIX_S21MATRIX_MEMORY_H
+
+#include <cstddef>
+#include <new>
+
+// thrown instead of allocating past the budget; a std::bad_alloc, so the
+// Try* operations report it as S21Status::kOutOfMemory
+class S21MemoryBudgetExceeded : public std::bad_alloc {
+ public:
+  S21MemoryBudgetExceeded(std::size_t requested, std::size_t budget);
+
+  const char* what() const noexcept override;
+  std::size_t getRequested() const;
+  std::size_t getBudget() const;
+
+ private:
+  std::size_t requested_, budget_;
+};
+
+// Process-wide count of the element bytes held in matrix heap buffers.
+// Matrices stored inline or in shared memory are not counted.
+class S21MemoryTracker {
+ public:
+  static std::size_t getLiveBytes();
+  static std::size_t getPeakBytes();
+  static void ResetPeak();
+  // a budget of 0 means unlimited
+  static std::size_t getBudget();
+  static void setBudget(std::size_t bytes);
+
+ private:
+  friend class S21Matrix;
+
+  static void Reserve(std::size_t bytes);
+  static void Release(std::size_t bytes) noexcept;
+};
+
+// matrix bytes allocated and freed by the current thread while the scope is
+// alive, nested scopes included
+class S21MemoryScope {
+ public:
+  S21MemoryScope();
+  S21MemoryScope(const S21MemoryScope&) = delete;
+  S21MemoryScope& operator=(const S21MemoryScope&) = delete;
+  ~S21MemoryScope();
+
+  std::size_t getAllocatedBytes() const;
+  std::size_t getFreedBytes() const;
+  // highest growth of allocated minus freed bytes since construction
+  std::size_t getPeakBytes() const;
+
+ private:
+  std::size_t allocated_, freed_;
+  long long base_, outer_peak_;
+};
+
+#endif  // S21_MATRIX_S21MATRIX_MEMORY_H
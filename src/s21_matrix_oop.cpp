@@ -1,232 +1,859 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_async.h"
+#include "s21_matrix_kernels.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_solvers.h"
+#include "s21_matrix_trace.h"
+#include "s21_matrix_tuning.h"
+
+// const operations on one matrix may run concurrently and fill the cache,
+// so everything except version, which only writes change, is read and
+// written under mutex
+struct S21Matrix::Cache {
+  Cache() = default;
+  // copies the values, the counters of the target are kept
+  Cache(const Cache &other) { *this = other; }
+  Cache &operator=(const Cache &other);
+
+  mutable std::mutex mutex;
+  // globally unique stamp of the current contents; copies share it
+  std::uint64_t version = 0;
+  bool has_determinant = false;
+  double determinant = 0;
+  bool has_hash = false;
+  std::size_t hash = 0;
+  std::shared_ptr<const S21Matrix> inverse;
+  std::shared_ptr<const S21LU> lu;
+  std::uint64_t compared_version = 0;
+  bool compared_result = false;
+  long long hits = 0, misses = 0;
+};
+
+S21Matrix::Cache &S21Matrix::Cache::operator=(const Cache &other) {
+  if (this == &other) return *this;
+  std::lock_guard<std::mutex> lock(other.mutex);
+  version = other.version;
+  has_determinant = other.has_determinant;
+  determinant = other.determinant;
+  has_hash = other.has_hash;
+  hash = other.hash;
+  inverse = other.inverse;
+  lu = other.lu;
+  compared_version = other.compared_version;
+  compared_result = other.compared_result;
+  return *this;
+}
+
+// reference-counted element storage; heap buffers keep the elements right
+// after the header, external ones (shared memory) are freed through release
+struct alignas(64) S21Matrix::Buffer {
+  std::atomic<int> refs;
+  std::size_t size;
+  double *data;
+  bool read_only;
+  void (*release)(void *context);
+  void *context;
+};
+
+namespace {
+
+std::uint64_t NextVersion() {
+  static std::atomic<std::uint64_t> counter{0};
+  return ++counter;
+}
+
+// maps a failed status onto the exception the throwing API has always used
+template <typename SizeError>
+void ThrowIfFailed(S21Status status) {
+  switch (status) {
+    case S21Status::kOk:
+      return;
+    case S21Status::kIndexOutOfRange:
+      throw std::out_of_range("index is out of range");
+    case S21Status::kSingular:
+      throw std::invalid_argument("invalid matrix!");
+    case S21Status::kOutOfMemory:
+      throw std::bad_alloc();
+    case S21Status::kSizeMismatch:
+      break;
+  }
+  throw SizeError("invalid size of matrix!");
+}
+
+// op(begin, end) over [0, size); large ranges are split across the default
+// executor when it can be started. Setting up the split may fail before any
+// element is touched, and then everything runs here.
+template <typename Op>
+void ForEachElement(int size, const Op &op) noexcept {
+  S21Executor *executor = nullptr;
+  if (size >= S21Tuning().elementwise_parallel_min)
+    executor = S21Executor::TryDefault();
+  if (executor) {
+    try {
+      int grain = std::max(1 << 12, size / (4 * executor->getThreadCount()));
+      executor->ParallelFor(size, grain, [&op](const auto &next) {
+        int begin, end;
+        while (next(begin, end)) op(begin, end);
+      });
+      return;
+    } catch (const std::bad_alloc &) {
+    }
+  }
+  op(0, size);
+}
+
+}  // namespace
+
 // constructors
-S21Matrix::S21Matrix() {
+S21Matrix::S21Matrix() noexcept {
   rows_ = 0;
   cols_ = 0;
   matrix_ = nullptr;
+  buffer_ = nullptr;
+  cow_ = false;
+  unshareable_ = false;
 }
 
 S21Matrix::S21Matrix(int rows, int cols) {
   if (rows < 1 || cols < 1) throw std::out_of_range("invalid length!");
   rows_ = rows;
   cols_ = cols;
-  matrix_ = new double *[rows_];
-  for (int i = 0; i < rows_; ++i) {
-    matrix_[i] = new double[cols_]();
-  }
+  cow_ = false;
+  allocateMatrix(true);
+}
+
+S21Matrix::S21Matrix(int rows, int cols, S21Uninitialized) {
+  if (rows < 1 || cols < 1) throw std::out_of_range("invalid length!");
+  rows_ = rows;
+  cols_ = cols;
+  cow_ = false;
+  allocateMatrix(false);
 }
 
 S21Matrix::S21Matrix(const S21Matrix &other) {
   rows_ = other.rows_;
   cols_ = other.cols_;
-  matrix_ = new double *[rows_];
-  for (int i = 0; i < rows_; ++i) {
-    matrix_[i] = new double[cols_]();
-  }
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
+  cow_ = other.cow_;
+  if (cow_ && !other.unshareable_) {
+    shareMatrix(other);
+  } else {
+    allocateMatrix(false);
+    std::copy_n(other.matrix_, rows_ * cols_, matrix_);
   }
+  if (other.cache_) cache_ = std::make_unique<Cache>(*other.cache_);
 }
 
-S21Matrix::S21Matrix(S21Matrix &&other) {
-  rows_ = other.rows_;
-  cols_ = other.cols_;
-  matrix_ = other.matrix_;
-  other.matrix_ = nullptr;
-  other.rows_ = other.cols_ = 0;
+S21Matrix::S21Matrix(S21Matrix &&other) noexcept {
+  cow_ = other.cow_;
+  cache_ = std::move(other.cache_);
+  moveMatrix(other);
 }
 
 // accessors
 int S21Matrix::getRows() const { return rows_; }
 int S21Matrix::getCols() const { return cols_; }
+bool S21Matrix::isCacheEnabled() const { return cache_ != nullptr; }
+long long S21Matrix::getCacheHits() const {
+  if (!cache_) return 0;
+  std::lock_guard<std::mutex> lock(cache_->mutex);
+  return cache_->hits;
+}
+long long S21Matrix::getCacheMisses() const {
+  if (!cache_) return 0;
+  std::lock_guard<std::mutex> lock(cache_->mutex);
+  return cache_->misses;
+}
+bool S21Matrix::isCopyOnWrite() const { return cow_; }
+bool S21Matrix::isInline() const {
+  return matrix_ != nullptr && matrix_ == inline_;
+}
+bool S21Matrix::isShared() const {
+  return buffer_ && (buffer_->read_only ||
+                     buffer_->refs.load(std::memory_order_acquire) > 1);
+}
 
 // mutators
 void S21Matrix::setRows(int rows) {
   if (rows <= 0)
     throw std::out_of_range("Incorrect input, index is out of range");
 
-  S21Matrix result(rows, cols_);
-  for (int i = 0; i < rows_ && i < result.rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      result.matrix_[i][j] = matrix_[i][j];
-    }
-  }
-  *this = result;
+  S21Matrix result(rows, cols_, kS21Uninitialized);
+  int kept = std::min(rows_, rows) * cols_;
+  std::copy_n(matrix_, kept, result.matrix_);
+  std::fill(result.matrix_ + kept, result.matrix_ + rows * cols_, 0.0);
+  *this = std::move(result);
 }
 void S21Matrix::setCols(int cols) {
   if (cols <= 0)
     throw std::out_of_range("Incorrect input, index is out of range");
 
-  S21Matrix result(rows_, cols);
+  S21Matrix result(rows_, cols, kS21Uninitialized);
+  int kept = std::min(cols_, cols);
   for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_ && j < result.cols_; ++j) {
-      result.matrix_[i][j] = matrix_[i][j];
-    }
+    double *row = result.matrix_ + i * cols;
+    std::copy_n(matrix_ + i * cols_, kept, row);
+    std::fill(row + kept, row + cols, 0.0);
+  }
+  *this = std::move(result);
+}
+
+// copies of a copy-on-write matrix share its storage until one of them
+// writes. Once a mutable reference or iterator has been taken while
+// copy-on-write is on, copies are deep until the storage is replaced;
+// references taken before enabling it must not be written through after
+// copies are made.
+void S21Matrix::setCopyOnWrite(bool enabled) {
+  if (!enabled) detachMatrix();
+  cow_ = enabled;
+}
+
+// derived values are kept until the next mutating call, each non-const
+// element access included; a reference or iterator kept from an earlier
+// access is not tracked, so writes through it leave stale values behind
+void S21Matrix::setCacheEnabled(bool enabled) {
+  if (!enabled) {
+    cache_.reset();
+  } else if (!cache_) {
+    cache_ = std::make_unique<Cache>();
+    cache_->version = NextVersion();
   }
-  *this = result;
 }
 
 // operations
-bool S21Matrix::EqMatrix(const S21Matrix &other) {
-  if (rows_ == other.rows_ && cols_ == other.cols_) {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        if (fabs(matrix_[i][j] - other.matrix_[i][j]) > 1e-7) {
-          return false;
-        }
-      }
+bool S21Matrix::EqMatrix(const S21Matrix &other) const {
+  S21_TRACE("EqMatrix", rows_, cols_);
+  bool versioned = cache_ && other.cache_;
+  if (versioned) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    if (cache_->version == other.cache_->version ||
+        cache_->compared_version == other.cache_->version) {
+      ++cache_->hits;
+      return cache_->version == other.cache_->version ||
+             cache_->compared_result;
     }
-    return true;
+    ++cache_->misses;
+  }
+
+  bool result = rows_ == other.rows_ && cols_ == other.cols_;
+  for (int i = 0; result && i < rows_ * cols_; ++i) {
+    if (fabs(matrix_[i] - other.matrix_[i]) > 1e-7) result = false;
+  }
+  if (versioned) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    cache_->compared_version = other.cache_->version;
+    cache_->compared_result = result;
   }
-  return false;
+  return result;
 }
 void S21Matrix::SumMatrix(const S21Matrix &other) {
-  if (rows_ != other.rows_ || cols_ != other.cols_)
-    throw std::out_of_range("invalid size of matrix!");
+  ThrowIfFailed<std::out_of_range>(TrySumMatrix(other));
+}
 
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] += other.matrix_[i][j];
+void S21Matrix::SubMatrix(const S21Matrix &other) {
+  ThrowIfFailed<std::out_of_range>(TrySubMatrix(other));
+}
+
+void S21Matrix::MulNumber(const double num) {
+  S21_TRACE("MulNumber", rows_, cols_);
+  BeginWrite();
+  double *data = matrix_;
+  ForEachElement(rows_ * cols_, [data, num](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      data[i] *= num;
+    }
+  });
+}
+
+void S21Matrix::MulMatrix(const S21Matrix &other) {
+  ThrowIfFailed<std::logic_error>(TryMulMatrix(other));
+}
+
+S21Matrix S21Matrix::Transpose() const {
+  S21_TRACE("Transpose", rows_, cols_);
+  S21Matrix result(cols_, rows_, kS21Uninitialized);
+  int block = S21Tuning().transpose_block;
+  for (int ii = 0; ii < rows_; ii += block) {
+    int i_end = std::min(ii + block, rows_);
+    for (int jj = 0; jj < cols_; jj += block) {
+      int j_end = std::min(jj + block, cols_);
+      for (int i = ii; i < i_end; ++i) {
+        for (int j = jj; j < j_end; ++j) {
+          result.matrix_[j * rows_ + i] = matrix_[i * cols_ + j];
+        }
+      }
     }
   }
+  return result;
 }
 
-void S21Matrix::SubMatrix(const S21Matrix &other) {
-  if (rows_ != other.rows_ || cols_ != other.cols_)
+S21Matrix S21Matrix::CalcComplements() const {
+  S21_TRACE("CalcComplements", rows_, cols_);
+  if (rows_ != cols_ || rows_ < 2)
     throw std::out_of_range("invalid size of matrix!");
 
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] -= other.matrix_[i][j];
+  int n = rows_, minor = rows_ - 1;
+  S21Matrix result(n, n, kS21Uninitialized);
+  long flops = (long)minor * minor * minor;
+  int grain = (int)std::max(1L, S21Tuning().parallel_grain / flops);
+  S21ParallelFor(n * n, grain, [this, &result, n, minor](const auto &next) {
+    std::vector<double> work(minor * minor);
+    std::vector<double *> rows(minor);
+    int begin, end;
+    while (next(begin, end)) {
+      for (int cell = begin; cell < end; ++cell) {
+        int i = cell / n, j = cell % n;
+        CopyMinor(i, j, work.data());
+        double det = s21_kernels::Determinant(work.data(), rows.data(), minor);
+        result.matrix_[cell] = (i + j) % 2 ? -det : det;
+      }
     }
-  }
+  });
+  return result;
+}
+// fraction-free (Bareiss) elimination: O(n^3) and exact for integer matrices
+double S21Matrix::Determinant() const {
+  S21Expected<double> result = TryDeterminant();
+  ThrowIfFailed<std::out_of_range>(result.error());
+  return *result;
 }
 
-void S21Matrix::MulNumber(const double num) {
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] *= num;
+// always by elimination, so the value does not depend on what the cache
+// happens to hold; a cached factorization would round differently
+double S21Matrix::ComputeDeterminant() const {
+  if (rows_ == 0) return 0;
+  if (cache_) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    if (cache_->has_determinant) {
+      ++cache_->hits;
+      return cache_->determinant;
     }
+    ++cache_->misses;
+  }
+
+  std::vector<double> work(matrix_, matrix_ + rows_ * cols_);
+  std::vector<double *> rows(rows_);
+  double result = s21_kernels::Determinant(work.data(), rows.data(), rows_);
+  if (cache_) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    cache_->determinant = result;
+    cache_->has_determinant = true;
   }
+  return result;
 }
 
-void S21Matrix::MulMatrix(const S21Matrix &other) {
-  if (cols_ != other.rows_ || !other.isValid() || !this->isValid())
-    throw std::logic_error("invalid size of matrix!");
+S21Matrix S21Matrix::InverseMatrix() const {
+  S21Expected<S21Matrix> result = TryInverseMatrix();
+  ThrowIfFailed<std::invalid_argument>(result.error());
+  return std::move(*result);
+}
 
-  S21Matrix result(rows_, other.cols_);
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < other.cols_; ++j) {
-      for (int k = 0; k < cols_; ++k) {
-        result.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
+S21Matrix S21Matrix::Solve(const S21Matrix &b) const {
+  S21_TRACE("Solve", rows_, b.cols_);
+  return Factorization()->Solve(b);
+}
+
+S21Matrix S21Matrix::SolveMixed(const S21Matrix &b,
+                                S21RefinementInfo *info) const {
+  S21_TRACE("SolveMixed", rows_, b.cols_);
+  return S21MixedLU(*this).Solve(b, info);
+}
+
+S21Matrix S21Matrix::InverseMixed(S21RefinementInfo *info) const {
+  S21_TRACE("InverseMixed", rows_, cols_);
+  if (rows_ != cols_ || rows_ < 1)
+    throw std::invalid_argument("invalid size of matrix!");
+
+  S21MixedLU lu(*this);
+  if (!lu.isSingular() && fabs(lu.Determinant()) >= 1e-7)
+    return lu.Inverse(info);
+
+  // single precision cannot hold or factor the matrix, or puts it near the
+  // singularity threshold: decided and inverted in double
+  S21Matrix result = InverseMatrix();
+  if (info) *info = S21RefinementInfo{0, false, true};
+  return result;
+}
+
+S21Matrix S21Matrix::SolveTriangular(const S21Matrix &b, S21Triangle triangle,
+                                     bool unit_diagonal) const {
+  S21_TRACE("SolveTriangular", rows_, b.cols_);
+  if (rows_ != cols_ || b.rows_ != rows_ || !isValid() || !b.isValid())
+    throw std::out_of_range("invalid size of matrix!");
+
+  S21Matrix result(b);
+  result.BeginWrite();
+  if (!s21_kernels::Trsm(matrix_, result.matrix_, rows_, b.cols_,
+                         triangle == S21Triangle::kLower, unit_diagonal))
+    throw std::invalid_argument("invalid matrix!");
+  return result;
+}
+
+S21Matrix S21Matrix::TransposeMul() const {
+  S21_TRACE("TransposeMul", rows_, cols_);
+  S21Matrix result(cols_, cols_, kS21Uninitialized);
+  s21_kernels::SyrkTransposed(matrix_, result.matrix_, rows_, cols_);
+  MirrorLower(result);
+  return result;
+}
+
+S21Matrix S21Matrix::MulTranspose() const {
+  S21_TRACE("MulTranspose", rows_, cols_);
+  S21Matrix result(rows_, rows_, kS21Uninitialized);
+  s21_kernels::Syrk(matrix_, result.matrix_, rows_, cols_);
+  MirrorLower(result);
+  return result;
+}
+
+// binary exponentiation, two scratch buffers are swapped instead of
+// allocating a new product per step
+S21Matrix S21Matrix::Power(int k) const {
+  S21_TRACE("Power", rows_, cols_);
+  if (rows_ != cols_ || rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+  if (k == 0) return Identity(rows_);
+
+  S21Matrix base = k > 0 ? *this : InverseMatrix();
+  base.setCacheEnabled(false);
+  unsigned int exponent = k > 0 ? k : -(unsigned int)k;
+  S21Matrix result, scratch(rows_, cols_, kS21Uninitialized);
+  bool started = false;
+  while (true) {
+    if (exponent & 1) {
+      if (started) {
+        MulInto(result, base, scratch);
+        result.swapMatrix(scratch);
+      } else {
+        result = base;
+        started = true;
       }
     }
+    exponent >>= 1;
+    if (!exponent) break;
+    MulInto(base, base, scratch);
+    base.swapMatrix(scratch);
   }
-  *this = result;
+  return result;
 }
 
-S21Matrix S21Matrix::Transpose() {
-  S21Matrix result(cols_, rows_);
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      result.matrix_[j][i] = matrix_[i][j];
+// scaling and squaring with the [13/13] Pade approximant (Higham, 2005)
+S21Matrix S21Matrix::Exp() const {
+  S21_TRACE("Exp", rows_, cols_);
+  if (rows_ != cols_ || rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  static const double b[] = {64764752532480000.0,
+                             32382376266240000.0,
+                             7771770303897600.0,
+                             1187353796428800.0,
+                             129060195264000.0,
+                             10559470521600.0,
+                             670442572800.0,
+                             33522128640.0,
+                             1323241920.0,
+                             40840800.0,
+                             960960.0,
+                             16380.0,
+                             182.0,
+                             1.0};
+  const double theta13 = 5.371920351148152;
+
+  double norm = 0;
+  for (int j = 0; j < cols_; ++j) {
+    double column_sum = 0;
+    for (int i = 0; i < rows_; ++i) {
+      column_sum += fabs(matrix_[i * cols_ + j]);
     }
+    norm = std::max(norm, column_sum);
+  }
+  int squarings = norm > theta13 ? (int)ceil(log2(norm / theta13)) : 0;
+
+  int n = rows_;
+  S21Matrix a(*this);
+  a.MulNumber(ldexp(1.0, -squarings));
+  S21Matrix a2(n, n, kS21Uninitialized), a4(n, n, kS21Uninitialized),
+      a6(n, n, kS21Uninitialized);
+  MulInto(a, a, a2);
+  MulInto(a2, a2, a4);
+  MulInto(a4, a2, a6);
+
+  S21Matrix inner_u(n, n, kS21Uninitialized), inner_v(n, n, kS21Uninitialized),
+      u_part(n, n, kS21Uninitialized), v_part(n, n, kS21Uninitialized);
+  for (int i = 0; i < n * n; ++i) {
+    inner_u.matrix_[i] =
+        b[13] * a6.matrix_[i] + b[11] * a4.matrix_[i] + b[9] * a2.matrix_[i];
+    inner_v.matrix_[i] =
+        b[12] * a6.matrix_[i] + b[10] * a4.matrix_[i] + b[8] * a2.matrix_[i];
+  }
+  MulInto(a6, inner_u, u_part);
+  MulInto(a6, inner_v, v_part);
+  for (int i = 0; i < n * n; ++i) {
+    u_part.matrix_[i] +=
+        b[7] * a6.matrix_[i] + b[5] * a4.matrix_[i] + b[3] * a2.matrix_[i];
+    v_part.matrix_[i] +=
+        b[6] * a6.matrix_[i] + b[4] * a4.matrix_[i] + b[2] * a2.matrix_[i];
+  }
+  for (int i = 0; i < n; ++i) {
+    u_part.matrix_[i * n + i] += b[1];
+    v_part.matrix_[i * n + i] += b[0];
+  }
+  S21Matrix u(n, n, kS21Uninitialized);
+  MulInto(a, u_part, u);
+
+  // exp(A) ~ (V - U)^-1 (V + U)
+  S21Matrix numerator = v_part + u;
+  v_part.SubMatrix(u);
+  S21Matrix result = S21LU(v_part).Solve(numerator);
+  S21Matrix scratch(n, n, kS21Uninitialized);
+  for (int i = 0; i < squarings; ++i) {
+    MulInto(result, result, scratch);
+    result.swapMatrix(scratch);
   }
   return result;
 }
 
-S21Matrix S21Matrix::CalcComplements() {
-  if (rows_ != cols_) throw std::out_of_range("invalid size of matrix!");
+// non-throwing operations, the throwing ones above are built on these
+S21Status S21Matrix::TrySumMatrix(const S21Matrix &other) noexcept {
+  S21_TRACE("SumMatrix", rows_, cols_);
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    return S21Status::kSizeMismatch;
+  try {
+    BeginWrite();
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
+  }
 
-  S21Matrix result(rows_, cols_);
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      S21Matrix complementMatrix = this->GetComplementMatrix(i, j);
-      result.matrix_[i][j] = complementMatrix.Determinant();
-      if ((i + j) % 2) result.matrix_[i][j] *= -1;
+  double *data = matrix_;
+  const double *addend = other.matrix_;
+  ForEachElement(rows_ * cols_, [data, addend](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      data[i] += addend[i];
     }
+  });
+  return S21Status::kOk;
+}
+
+S21Status S21Matrix::TrySubMatrix(const S21Matrix &other) noexcept {
+  S21_TRACE("SubMatrix", rows_, cols_);
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    return S21Status::kSizeMismatch;
+  try {
+    BeginWrite();
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
   }
-  return result;
+
+  double *data = matrix_;
+  const double *subtrahend = other.matrix_;
+  ForEachElement(rows_ * cols_, [data, subtrahend](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      data[i] -= subtrahend[i];
+    }
+  });
+  return S21Status::kOk;
 }
-double S21Matrix::Determinant() {
-  if (rows_ != cols_) throw std::out_of_range("invalid size of matrix!");
 
-  double result = 0, temp = 0;
-  int sign = 1;
-  if (rows_ == 1) {
-    result = matrix_[0][0];
-  } else {
-    for (int j = 0; j < cols_; ++j) {
-      S21Matrix complementMatrix = this->GetComplementMatrix(0, j);
-      temp = complementMatrix.Determinant();
-      result += sign * matrix_[0][j] * temp;
-      sign *= -1;
+S21Status S21Matrix::TryMulMatrix(const S21Matrix &other) noexcept {
+  S21_TRACE("MulMatrix", rows_, other.cols_);
+  if (cols_ != other.rows_ || !other.isValid() || !this->isValid())
+    return S21Status::kSizeMismatch;
+
+  try {
+    S21Matrix result(rows_, other.cols_, kS21Uninitialized);
+    s21_kernels::Gemm(matrix_, other.matrix_, result.matrix_, cols_,
+                      other.cols_, 0, rows_);
+    *this = std::move(result);
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
+  }
+  return S21Status::kOk;
+}
+
+S21Expected<double> S21Matrix::TryDeterminant() const noexcept {
+  S21_TRACE("Determinant", rows_, cols_);
+  if (rows_ != cols_) return S21Status::kSizeMismatch;
+  try {
+    return ComputeDeterminant();
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
+  }
+}
+
+S21Expected<S21Matrix> S21Matrix::TryInverseMatrix() const noexcept {
+  S21_TRACE("InverseMatrix", rows_, cols_);
+  if (rows_ != cols_ || rows_ < 1) return S21Status::kSizeMismatch;
+  try {
+    if (cache_) {
+      std::unique_lock<std::mutex> lock(cache_->mutex);
+      if (cache_->inverse) {
+        ++cache_->hits;
+        std::shared_ptr<const S21Matrix> inverse = cache_->inverse;
+        lock.unlock();
+        return S21Matrix(*inverse);
+      }
+      ++cache_->misses;
+    }
+
+    // singular exactly when Determinant() says so
+    std::shared_ptr<const S21LU> lu = Factorization();
+    if (lu->isSingular() || fabs(ComputeDeterminant()) < 1e-7)
+      return S21Status::kSingular;
+    S21Matrix result = lu->Inverse();
+    if (cache_) {
+      auto inverse = std::make_shared<const S21Matrix>(result);
+      std::lock_guard<std::mutex> lock(cache_->mutex);
+      cache_->inverse = std::move(inverse);
     }
+    return result;
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
+  }
+}
+
+S21Expected<double> S21Matrix::TryGet(int row, int col) const noexcept {
+  if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
+    return S21Status::kIndexOutOfRange;
+  return matrix_[row * cols_ + col];
+}
+
+S21Status S21Matrix::TrySet(int row, int col, double value) noexcept {
+  if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
+    return S21Status::kIndexOutOfRange;
+  try {
+    BeginWrite();
+  } catch (const std::bad_alloc &) {
+    return S21Status::kOutOfMemory;
   }
+  matrix_[row * cols_ + col] = value;
+  return S21Status::kOk;
+}
+
+// fraction-free elimination per matrix, as in Determinant(); cached
+// determinants are taken as they are
+std::vector<double> S21Matrix::Determinants(
+    std::span<const S21Matrix> matrices) {
+  S21_TRACE("Determinants", (int)matrices.size(), 0);
+  double flops = 0;
+  for (const S21Matrix &m : matrices) {
+    if (m.rows_ != m.cols_) throw std::out_of_range("invalid size of matrix!");
+    flops += (double)m.rows_ * m.rows_ * m.rows_;
+  }
+
+  std::vector<double> result(matrices.size());
+  int count = (int)matrices.size();
+  int grain = (int)std::max(
+      1.0, (double)S21Tuning().parallel_grain * count / (flops + 1));
+  S21ParallelFor(count, grain, [&matrices, &result](const auto &next) {
+    std::vector<double> work;
+    std::vector<double *> rows;
+    int begin, end;
+    while (next(begin, end)) {
+      for (int k = begin; k < end; ++k) {
+        const S21Matrix &m = matrices[k];
+        if (m.cache_) {
+          std::lock_guard<std::mutex> lock(m.cache_->mutex);
+          if (m.cache_->has_determinant) {
+            result[k] = m.cache_->determinant;
+            continue;
+          }
+        }
+        work.assign(m.matrix_, m.matrix_ + m.rows_ * m.cols_);
+        rows.resize(m.rows_);
+        result[k] = s21_kernels::Determinant(work.data(), rows.data(), m.rows_);
+      }
+    }
+  });
   return result;
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
-  if (rows_ != cols_) throw std::invalid_argument("invalid size of matrix!");
+S21Matrix S21Matrix::MultiplyChain(
+    const std::vector<std::reference_wrapper<const S21Matrix>> &chain) {
+  S21_TRACE("MultiplyChain", (int)chain.size(), 0);
+  int n = (int)chain.size();
+  if (n == 0) throw std::logic_error("invalid size of matrix!");
+  std::vector<int> dims(n + 1);
+  dims[0] = chain[0].get().rows_;
+  for (int k = 0; k < n; ++k) {
+    const S21Matrix &m = chain[k];
+    if (!m.isValid() || m.rows_ != dims[k])
+      throw std::logic_error("invalid size of matrix!");
+    dims[k + 1] = m.cols_;
+  }
+  if (n == 1) return chain[0];
+
+  // cost[i * n + j] is the cheapest way to form chain[i..j], split[i * n + j]
+  // the last product, of chain[i..s] and chain[s + 1..j]
+  std::vector<double> cost(n * n, 0);
+  std::vector<int> split(n * n);
+  for (int length = 2; length <= n; ++length) {
+    for (int i = 0; i + length <= n; ++i) {
+      int j = i + length - 1;
+      cost[i * n + j] = INFINITY;
+      for (int s = i; s < j; ++s) {
+        double c = cost[i * n + s] + cost[(s + 1) * n + j] +
+                   (double)dims[i] * dims[s + 1] * dims[j + 1];
+        if (c < cost[i * n + j]) {
+          cost[i * n + j] = c;
+          split[i * n + j] = s;
+        }
+      }
+    }
+  }
+
+  // intermediates go back to a pool once consumed and later products are
+  // written into the smallest spare buffer that fits
+  std::vector<S21Matrix> spare;
+  auto acquire = [&spare](int rows, int cols) {
+    std::size_t size = (std::size_t)rows * cols;
+    auto best = spare.end();
+    for (auto it = spare.begin(); it != spare.end(); ++it) {
+      if (it->buffer_->size >= size &&
+          (best == spare.end() || it->buffer_->size < best->buffer_->size))
+        best = it;
+    }
+    if (size <= (std::size_t)kInlineCapacity || best == spare.end())
+      return S21Matrix(rows, cols, kS21Uninitialized);
+    S21Matrix result(std::move(*best));
+    spare.erase(best);
+    result.rows_ = rows;
+    result.cols_ = cols;
+    return result;
+  };
+  auto release = [&spare](S21Matrix &m) {
+    if (m.buffer_ && !m.isShared()) spare.push_back(std::move(m));
+  };
+  auto product = [&](auto &self, int i, int j) -> S21Matrix {
+    int s = split[i * n + j];
+    S21Matrix left, right;
+    if (s > i) left = self(self, i, s);
+    if (s + 1 < j) right = self(self, s + 1, j);
+    // the final product is returned, so it gets a buffer of its own size
+    S21Matrix result = i == 0 && j == n - 1
+                           ? S21Matrix(dims[0], dims[n], kS21Uninitialized)
+                           : acquire(dims[i], dims[j + 1]);
+    MulInto(s > i ? left : chain[i].get(), s + 1 < j ? right : chain[j].get(),
+            result);
+    release(left);
+    release(right);
+    return result;
+  };
+  return product(product, 0, n - 1);
+}
 
-  double det = this->Determinant();
-  if (fabs(det) < 1e-7) throw std::invalid_argument("invalid matrix!");
+// FNV-1a over the shape and the element bit patterns
+std::size_t S21Matrix::Hash() const {
+  S21_TRACE("Hash", rows_, cols_);
+  if (cache_) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    if (cache_->has_hash) {
+      ++cache_->hits;
+      return cache_->hash;
+    }
+    ++cache_->misses;
+  }
 
-  S21Matrix minor = this->CalcComplements();
-  S21Matrix result = minor.Transpose();
-  result.MulNumber(1.0 / det);
+  std::uint64_t result = 14695981039346656037ull;
+  auto mix = [&result](const void *data, std::size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      result = (result ^ bytes[i]) * 1099511628211ull;
+    }
+  };
+  mix(&rows_, sizeof(rows_));
+  mix(&cols_, sizeof(cols_));
+  mix(matrix_, sizeof(double) * rows_ * cols_);
+  if (cache_) {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    cache_->hash = result;
+    cache_->has_hash = true;
+  }
   return result;
 }
 
 // operators
-S21Matrix S21Matrix::operator+(const S21Matrix &o) {
+S21Matrix S21Matrix::operator+(const S21Matrix &o) const {
   S21Matrix result(*this);
   result.SumMatrix(o);
   return result;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix &o) {
+S21Matrix S21Matrix::operator-(const S21Matrix &o) const {
   S21Matrix result(*this);
   result.SubMatrix(o);
   return result;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &o) {
+S21Matrix S21Matrix::operator*(const S21Matrix &o) const {
   S21Matrix result(*this);
   result.MulMatrix(o);
   return result;
 }
-S21Matrix S21Matrix::operator*(const double o) {
+S21Matrix S21Matrix::operator*(const double o) const {
   S21Matrix result(*this);
   result.MulNumber(o);
   return result;
 }
 
-bool S21Matrix::operator==(const S21Matrix &o) { return this->EqMatrix(o); }
+bool S21Matrix::operator==(const S21Matrix &o) const {
+  return this->EqMatrix(o);
+}
 
 S21Matrix &S21Matrix::operator=(const S21Matrix &o) {
   if (this != &o) {
+    // the copy is made aside, a failed allocation leaves this matrix as it was
+    S21Matrix copy;
+    copy.rows_ = o.rows_;
+    copy.cols_ = o.cols_;
+    if (o.cow_ && !o.unshareable_) {
+      copy.shareMatrix(o);
+    } else {
+      copy.allocateMatrix(false);
+      std::copy_n(o.matrix_, copy.rows_ * copy.cols_, copy.matrix_);
+    }
     deleteMatrix();
+    moveMatrix(copy);
 
-    rows_ = o.rows_;
-    cols_ = o.cols_;
-    matrix_ = new double *[rows_];
-    for (int i = 0; i < rows_; ++i) {
-      matrix_[i] = new double[cols_]();
+    if (o.cow_) cow_ = true;
+    if (cache_ && o.cache_) {
+      *cache_ = *o.cache_;
+    } else {
+      Invalidate();
     }
+  }
+  return *this;
+}
 
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        matrix_[i][j] = o.matrix_[i][j];
-      }
+S21Matrix &S21Matrix::operator=(S21Matrix &&o) noexcept {
+  if (this != &o) {
+    deleteMatrix();
+    moveMatrix(o);
+    cow_ = cow_ || o.cow_;
+    if (cache_ && o.cache_) {
+      *cache_ = *o.cache_;
+    } else {
+      Invalidate();
     }
+    // the emptied matrix must not keep the version of the moved contents
+    o.Invalidate();
   }
   return *this;
 }
 
+void S21Matrix::swap(S21Matrix &other) noexcept {
+  swapMatrix(other);
+  std::swap(cow_, other.cow_);
+  std::swap(cache_, other.cache_);
+}
+
 S21Matrix &S21Matrix::operator+=(const S21Matrix &o) {
   this->SumMatrix(o);
   return *this;
@@ -250,38 +877,118 @@ S21Matrix &S21Matrix::operator*=(const double o) {
 double &S21Matrix::operator()(int row, int col) {
   if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
     throw std::out_of_range("index is out of range");
-  return matrix_[row][col];
+  BeginExposedWrite();
+  return matrix_[row * cols_ + col];
+}
+
+const double &S21Matrix::operator()(int row, int col) const {
+  if (row < 0 || col < 0 || row >= rows_ || col >= cols_)
+    throw std::out_of_range("index is out of range");
+  return matrix_[row * cols_ + col];
+}
+
+std::span<double> S21Matrix::Row(int row) {
+  if (row < 0 || row >= rows_) throw std::out_of_range("index is out of range");
+  BeginExposedWrite();
+  return std::span<double>(matrix_ + row * cols_, cols_);
+}
+
+std::span<const double> S21Matrix::Row(int row) const {
+  if (row < 0 || row >= rows_) throw std::out_of_range("index is out of range");
+  return std::span<const double>(matrix_ + row * cols_, cols_);
 }
 
 // helpers
-S21Matrix S21Matrix::GetComplementMatrix(int i_row, int j_col) {
-  S21Matrix result(rows_ - 1, cols_ - 1);
-  int set_row = 0, set_col = 0;
-  for (int i = 0; i < result.rows_; ++i) {
-    if (i == i_row) set_row = 1;
-    set_col = 0;
-    for (int j = 0; j < result.cols_; ++j) {
-      if (j == j_col) set_col = 1;
-      result.matrix_[i][j] = matrix_[i + set_row][j + set_col];
-    }
+// out receives the (rows - 1) x (cols - 1) matrix without row i_row and
+// column j_col
+void S21Matrix::CopyMinor(int i_row, int j_col, double *out) const {
+  for (int i = 0; i < rows_; ++i) {
+    if (i == i_row) continue;
+    const double *row = matrix_ + i * cols_;
+    out = std::copy(row, row + j_col, out);
+    out = std::copy(row + j_col + 1, row + cols_, out);
+  }
+}
+
+S21Matrix S21Matrix::Identity(int size) {
+  S21Matrix result(size, size);
+  for (int i = 0; i < size; ++i) {
+    result.matrix_[i * size + i] = 1;
   }
   return result;
 }
 
+// copies the lower triangle of a square matrix onto the upper one
+void S21Matrix::MirrorLower(S21Matrix &m) {
+  int n = m.rows_;
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j) {
+      m.matrix_[i * n + j] = m.matrix_[j * n + i];
+    }
+  }
+}
+
+// out = a * b, out must already have the shape of the product. Scratch
+// matrices trade storage by swapMatrix, which leaves cow_ behind, so shared
+// storage is replaced here whatever out's own flag says; its old contents
+// are never read.
+void S21Matrix::MulInto(const S21Matrix &a, const S21Matrix &b,
+                        S21Matrix &out) {
+  if (out.isShared()) {
+    out.deleteMatrix();
+    out.allocateMatrix(false);
+  }
+  out.BeginWrite();
+  s21_kernels::Gemm(a.matrix_, b.matrix_, out.matrix_, a.cols_, b.cols_, 0,
+                    a.rows_);
+}
+
 void S21Matrix::FillingMatrix() {
+  BeginWrite();
   for (int i = 0; i < rows_; ++i) {
     for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = i * cols_ + j;
+      matrix_[i * cols_ + j] = i * cols_ + j;
     }
   }
 }
 
 void S21Matrix::ZeroingMatrix() {
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = 0;
+  BeginWrite();
+  std::fill_n(matrix_, rows_ * cols_, 0.0);
+}
+
+void S21Matrix::BeginWrite() {
+  if (cow_) detachMatrix();
+  Invalidate();
+}
+
+// for accessors that return a mutable reference into the elements
+void S21Matrix::BeginExposedWrite() {
+  BeginWrite();
+  if (cow_) unshareable_ = true;
+}
+
+void S21Matrix::Invalidate() noexcept {
+  if (cache_) {
+    *cache_ = Cache();
+    cache_->version = NextVersion();
+  }
+}
+
+std::shared_ptr<const S21LU> S21Matrix::Factorization() const {
+  if (!cache_) return std::make_shared<const S21LU>(*this);
+  {
+    std::lock_guard<std::mutex> lock(cache_->mutex);
+    if (cache_->lu) {
+      ++cache_->hits;
+      return cache_->lu;
     }
+    ++cache_->misses;
   }
+  auto lu = std::make_shared<const S21LU>(*this);
+  std::lock_guard<std::mutex> lock(cache_->mutex);
+  if (!cache_->lu) cache_->lu = std::move(lu);
+  return cache_->lu;
 }
 
 bool S21Matrix::isValid() const {
@@ -289,14 +996,129 @@ bool S21Matrix::isValid() const {
   return true;
 }
 
-void S21Matrix::deleteMatrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      delete[](matrix_[i]);
+// small matrices live in inline_, larger ones in a heap buffer
+void S21Matrix::allocateMatrix(bool zero) {
+  std::size_t size = (std::size_t)rows_ * cols_;
+  if (size <= (std::size_t)kInlineCapacity) {
+    buffer_ = nullptr;
+    matrix_ = inline_;
+  } else {
+    S21_TRACE_ALLOCATION(size * sizeof(double));
+    S21MemoryTracker::Reserve(size * sizeof(double));
+    void *raw;
+    try {
+      raw = ::operator new(sizeof(Buffer) + size * sizeof(double),
+                           std::align_val_t(alignof(Buffer)));
+    } catch (...) {
+      S21MemoryTracker::Release(size * sizeof(double));
+      throw;
     }
-    delete[] matrix_;
+    buffer_ = new (raw) Buffer{{1}, size, nullptr, false, nullptr, nullptr};
+    buffer_->data = reinterpret_cast<double *>(buffer_ + 1);
+    matrix_ = buffer_->data;
+  }
+  unshareable_ = false;
+  if (zero) std::fill_n(matrix_, size, 0.0);
+}
+
+void S21Matrix::shareMatrix(const S21Matrix &other) {
+  if (other.isInline()) {
+    allocateMatrix(false);
+    std::copy_n(other.matrix_, rows_ * cols_, matrix_);
+    return;
+  }
+  buffer_ = other.buffer_;
+  matrix_ = other.matrix_;
+  unshareable_ = false;
+  if (buffer_) buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+// gives this matrix its own copy of the storage if it is shared
+void S21Matrix::detachMatrix() {
+  if (!isShared()) return;
+
+  Buffer *shared = buffer_;
+  allocateMatrix(false);
+  std::copy_n(shared->data, rows_ * cols_, matrix_);
+  releaseBuffer(shared);
+}
+
+// drops one reference and frees the buffer with the last one
+void S21Matrix::releaseBuffer(Buffer *buffer) noexcept {
+  if (buffer->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  if (buffer->release) {
+    buffer->release(buffer->context);
+  } else {
+    S21MemoryTracker::Release(buffer->size * sizeof(double));
   }
+  buffer->~Buffer();
+  ::operator delete(buffer, std::align_val_t(alignof(Buffer)));
+}
+
+// wraps elements owned by someone else; release(context) runs once the last
+// matrix using them is gone, or right away when wrapping fails. Writes to
+// read-only elements go to a private copy.
+S21Matrix S21Matrix::adoptMatrix(int rows, int cols, double *data,
+                                 bool read_only, void (*release)(void *),
+                                 void *context) {
+  S21Matrix result;
+  try {
+    void *raw =
+        ::operator new(sizeof(Buffer), std::align_val_t(alignof(Buffer)));
+    result.buffer_ = new (raw) Buffer{
+        {1}, (std::size_t)rows * cols, data, read_only, release, context};
+  } catch (...) {
+    release(context);
+    throw;
+  }
+  result.rows_ = rows;
+  result.cols_ = cols;
+  result.matrix_ = data;
+  result.cow_ = read_only;
+  return result;
+}
+
+// takes the storage of other, which is left empty; this must hold none
+void S21Matrix::moveMatrix(S21Matrix &other) noexcept {
+  rows_ = other.rows_;
+  cols_ = other.cols_;
+  buffer_ = other.buffer_;
+  unshareable_ = other.unshareable_;
+  if (other.isInline()) {
+    matrix_ = inline_;
+    std::copy_n(other.inline_, rows_ * cols_, inline_);
+  } else {
+    matrix_ = other.matrix_;
+  }
+  other.matrix_ = nullptr;
+  other.buffer_ = nullptr;
+  other.unshareable_ = false;
+  other.rows_ = other.cols_ = 0;
+}
+
+void S21Matrix::swapMatrix(S21Matrix &other) noexcept {
+  if (!isInline() && !other.isInline()) {
+    std::swap(rows_, other.rows_);
+    std::swap(cols_, other.cols_);
+    std::swap(matrix_, other.matrix_);
+    std::swap(buffer_, other.buffer_);
+    std::swap(unshareable_, other.unshareable_);
+    return;
+  }
+  S21Matrix temp;
+  temp.moveMatrix(*this);
+  moveMatrix(other);
+  other.moveMatrix(temp);
+}
+
+void S21Matrix::deleteMatrix() noexcept {
+  if (buffer_) releaseBuffer(buffer_);
+  buffer_ = nullptr;
+  matrix_ = nullptr;
+  unshareable_ = false;
 }
 
 // destructor
-S21Matrix::~S21Matrix() { deleteMatrix(); }
+S21Matrix::~S21Matrix() noexcept { deleteMatrix(); }
+
+void swap(S21Matrix &a, S21Matrix &b) noexcept { a.swap(b); }
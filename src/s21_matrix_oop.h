@@ -1,63 +1,271 @@
 #ifndef S21_MATRIX_S21MATRIX_H
 #define S21_MATRIX_S21MATRIX_H
 
+#include <assert.h>
 #include <math.h>
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+// matrices with at most this many elements are stored inside the object
+#ifndef S21_MATRIX_INLINE_CAPACITY
+#define S21_MATRIX_INLINE_CAPACITY 16
+#endif
+
+class S21LU;
+
+// tag for constructors that leave the elements uninitialized, for callers
+// that overwrite every element anyway
+struct S21Uninitialized {
+  explicit S21Uninitialized() = default;
+};
+inline constexpr S21Uninitialized kS21Uninitialized{};
+
+// triangle of a matrix used by S21Matrix::SolveTriangular
+enum class S21Triangle { kLower, kUpper };
+
+// result of the non-throwing Try* operations
+enum class S21Status {
+  kOk,
+  kSizeMismatch,
+  kIndexOutOfRange,
+  kSingular,
+  kOutOfMemory,
+};
+
+// value or failure status, modelled on std::expected
+template <typename T>
+class S21Expected {
+ public:
+  S21Expected(T value) : value_(std::move(value)), status_(S21Status::kOk) {}
+  S21Expected(S21Status status) : status_(status) {}
+
+  bool has_value() const noexcept { return value_.has_value(); }
+  explicit operator bool() const noexcept { return has_value(); }
+  S21Status error() const noexcept { return status_; }
+
+  T& value() & {
+    checked();
+    return *value_;
+  }
+  const T& value() const& {
+    checked();
+    return *value_;
+  }
+  T&& value() && {
+    checked();
+    return std::move(*value_);
+  }
+  T& operator*() & noexcept { return *value_; }
+  const T& operator*() const& noexcept { return *value_; }
+  T&& operator*() && noexcept { return std::move(*value_); }
+  T* operator->() noexcept { return &*value_; }
+  const T* operator->() const noexcept { return &*value_; }
+
+ private:
+  std::optional<T> value_;
+  S21Status status_;
+
+  void checked() const {
+    if (!value_) throw std::logic_error("S21Expected holds no value");
+  }
+};
+
+// outcome of a mixed-precision solve, see S21Matrix::SolveMixed
+struct S21RefinementInfo {
+  int iterations = 0;
+  bool converged = false;
+  bool fell_back = false;
+};
 
 class S21Matrix {
  public:
+  using iterator = double*;
+  using const_iterator = const double*;
+
+  static constexpr int kInlineCapacity =
+      S21_MATRIX_INLINE_CAPACITY > 0 ? S21_MATRIX_INLINE_CAPACITY : 1;
+
   // constructors
-  S21Matrix();
+  S21Matrix() noexcept;
   S21Matrix(int rows, int cols);
+  S21Matrix(int rows, int cols, S21Uninitialized);
   S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other);
-  ~S21Matrix();
+  S21Matrix(S21Matrix&& other) noexcept;
+  ~S21Matrix() noexcept;
 
   // accessors
   int getRows() const;
   int getCols() const;
+  bool isCacheEnabled() const;
+  long long getCacheHits() const;
+  long long getCacheMisses() const;
+  bool isCopyOnWrite() const;
+  bool isShared() const;
+  bool isInline() const;
 
   // mutators
   void setRows(int rows);
   void setCols(int cols);
+  void setCacheEnabled(bool enabled);
+  void setCopyOnWrite(bool enabled);
 
   // operations
-  bool EqMatrix(const S21Matrix& other);
+  bool EqMatrix(const S21Matrix& other) const;
   void SumMatrix(const S21Matrix& other);
   void SubMatrix(const S21Matrix& other);
   void MulNumber(const double num);
   void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
+  S21Matrix Transpose() const;
+  S21Matrix CalcComplements() const;
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  S21Matrix SolveMixed(const S21Matrix& b,
+                       S21RefinementInfo* info = nullptr) const;
+  S21Matrix InverseMixed(S21RefinementInfo* info = nullptr) const;
+  // this * x = b using only one triangle of this
+  S21Matrix SolveTriangular(const S21Matrix& b, S21Triangle triangle,
+                            bool unit_diagonal = false) const;
+  // symmetric this^T * this and this * this^T, only one triangle is computed
+  S21Matrix TransposeMul() const;
+  S21Matrix MulTranspose() const;
+  S21Matrix Power(int k) const;
+  S21Matrix Exp() const;
+  std::size_t Hash() const;
+  void swap(S21Matrix& other) noexcept;
+
+  // determinants of independent square matrices, spread over the default
+  // executor; each worker reuses one scratch buffer for all its matrices
+  static std::vector<double> Determinants(
+      std::span<const S21Matrix> matrices);
+  // a[0] * a[1] * ... in the order with the fewest multiplications, found by
+  // dynamic programming over the shapes
+  static S21Matrix MultiplyChain(
+      const std::vector<std::reference_wrapper<const S21Matrix>>& chain);
+
+  // non-throwing variants, preconditions are checked once up front
+  S21Status TrySumMatrix(const S21Matrix& other) noexcept;
+  S21Status TrySubMatrix(const S21Matrix& other) noexcept;
+  S21Status TryMulMatrix(const S21Matrix& other) noexcept;
+  S21Expected<double> TryDeterminant() const noexcept;
+  S21Expected<S21Matrix> TryInverseMatrix() const noexcept;
+  S21Expected<double> TryGet(int row, int col) const noexcept;
+  S21Status TrySet(int row, int col, double value) noexcept;
 
   // operators
   S21Matrix& operator=(const S21Matrix& o);
+  S21Matrix& operator=(S21Matrix&& o) noexcept;
   double& operator()(int row, int col);
+  const double& operator()(int row, int col) const;
   S21Matrix& operator+=(const S21Matrix& o);
-  S21Matrix operator+(const S21Matrix& o);
+  S21Matrix operator+(const S21Matrix& o) const;
   S21Matrix& operator-=(const S21Matrix& o);
-  S21Matrix operator-(const S21Matrix& o);
-  S21Matrix operator*(const S21Matrix& o);
+  S21Matrix operator-(const S21Matrix& o) const;
+  S21Matrix operator*(const S21Matrix& o) const;
   S21Matrix& operator*=(const double o);
-  S21Matrix operator*(const double o);
+  S21Matrix operator*(const double o) const;
   S21Matrix& operator*=(const S21Matrix& o);
-  bool operator==(const S21Matrix& o);
+  bool operator==(const S21Matrix& o) const;
+
+  // element access without bounds checks (asserted in debug builds)
+  double& At(int row, int col);
+  const double& At(int row, int col) const;
+  std::span<double> Row(int row);
+  std::span<const double> Row(int row) const;
+
+  // contiguous row-major iteration over all elements
+  double* Data();
+  const double* Data() const;
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const;
+  const_iterator cend() const;
 
   // helpers
   void FillingMatrix();
   void ZeroingMatrix();
 
  private:
+  friend class S21LU;
+  friend class S21Cholesky;
+  friend class S21QR;
+  friend class S21MixedLU;
+  friend class S21SharedMemory;
+
+  // derived values kept while the contents are unchanged, see setCacheEnabled
+  struct Cache;
+  struct Buffer;
+
   int rows_, cols_;
-  double** matrix_;
+  double* matrix_;
+  Buffer* buffer_;
+  bool cow_;
+  // a mutable reference, span or iterator into a copy-on-write buffer was
+  // handed out; later copies get their own elements, as with the
+  // unshareable state of copy-on-write std::string
+  bool unshareable_;
+  std::unique_ptr<Cache> cache_;
+  alignas(32) double inline_[kInlineCapacity];
 
   // helpers
-  void deleteMatrix();
+  void BeginWrite();
+  void BeginExposedWrite();
+  void Invalidate() noexcept;
+  std::shared_ptr<const S21LU> Factorization() const;
+  void allocateMatrix(bool zero);
+  void shareMatrix(const S21Matrix& other);
+  void detachMatrix();
+  void moveMatrix(S21Matrix& other) noexcept;
+  void swapMatrix(S21Matrix& other) noexcept;
+  void deleteMatrix() noexcept;
+  static void releaseBuffer(Buffer* buffer) noexcept;
+  static S21Matrix adoptMatrix(int rows, int cols, double* data,
+                               bool read_only, void (*release)(void*),
+                               void* context);
   bool isValid() const;
-  S21Matrix GetComplementMatrix(int i, int j);
+  void CopyMinor(int i, int j, double* out) const;
+  double ComputeDeterminant() const;
+  static S21Matrix Identity(int size);
+  static void MirrorLower(S21Matrix& m);
+  static void MulInto(const S21Matrix& a, const S21Matrix& b, S21Matrix& out);
 };
 
+void swap(S21Matrix& a, S21Matrix& b) noexcept;
+
+// hot-path accessors are inline so element loops can be vectorized
+inline double& S21Matrix::At(int row, int col) {
+  assert(row >= 0 && col >= 0 && row < rows_ && col < cols_);
+  if (cache_ || cow_) BeginExposedWrite();
+  return matrix_[row * cols_ + col];
+}
+
+inline const double& S21Matrix::At(int row, int col) const {
+  assert(row >= 0 && col >= 0 && row < rows_ && col < cols_);
+  return matrix_[row * cols_ + col];
+}
+
+inline double* S21Matrix::Data() {
+  if (cache_ || cow_) BeginExposedWrite();
+  return matrix_;
+}
+
+inline const double* S21Matrix::Data() const { return matrix_; }
+inline S21Matrix::iterator S21Matrix::begin() { return Data(); }
+inline S21Matrix::iterator S21Matrix::end() { return Data() + rows_ * cols_; }
+inline S21Matrix::const_iterator S21Matrix::begin() const { return matrix_; }
+inline S21Matrix::const_iterator S21Matrix::end() const {
+  return matrix_ + rows_ * cols_;
+}
+inline S21Matrix::const_iterator S21Matrix::cbegin() const { return begin(); }
+inline S21Matrix::const_iterator S21Matrix::cend() const { return end(); }
+
 #endif  // S21_MATRIX_S21MATRIX_H
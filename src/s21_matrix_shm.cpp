@@ -0,0 +1,156 @@
+#include "s21_matrix_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <system_error>
+
+namespace {
+
+constexpr std::uint64_t kMagic = 0x5332314d41545258;  // "S21MATRX"
+
+// start of a segment; the elements begin at the next page boundary
+struct Header {
+  std::atomic<std::uint64_t> magic;
+  std::atomic<int> refs;
+  int rows, cols;
+  std::size_t offset;
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<int>::is_always_lock_free,
+              "the reference count is shared between processes");
+
+// one mapping of a segment in this process
+struct Mapping {
+  std::string name;
+  void* address;
+  std::size_t length;
+};
+
+[[noreturn]] void ThrowSystemError(int error, const char* what) {
+  throw std::system_error(error, std::generic_category(), what);
+}
+
+// drops the reference of one mapping
+void Release(const std::string& name, void* address, std::size_t length) {
+  Header* header = static_cast<Header*>(address);
+  if (header->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    shm_unlink(name.c_str());
+  munmap(address, length);
+}
+
+// called once no matrix of this process uses the mapping
+void Unmap(void* context) {
+  Mapping* mapping = static_cast<Mapping*>(context);
+  Release(mapping->name, mapping->address, mapping->length);
+  delete mapping;
+}
+
+}  // namespace
+
+// the returned matrix owns the reference of the mapping
+S21Matrix S21SharedMemory::Wrap(const std::string& name, void* address,
+                                std::size_t length, bool read_only) {
+  Mapping* mapping;
+  try {
+    mapping = new Mapping{name, address, length};
+  } catch (...) {
+    Release(name, address, length);
+    throw;
+  }
+  Header* header = static_cast<Header*>(address);
+  double* data = reinterpret_cast<double*>(static_cast<char*>(address) +
+                                           header->offset);
+  return S21Matrix::adoptMatrix(header->rows, header->cols, data, read_only,
+                                Unmap, mapping);
+}
+
+S21Matrix S21SharedMemory::Create(const std::string& name, int rows,
+                                  int cols) {
+  if (rows < 1 || cols < 1) throw std::out_of_range("invalid length!");
+
+  std::size_t offset = (std::size_t)sysconf(_SC_PAGESIZE);
+  std::size_t length = offset + (std::size_t)rows * cols * sizeof(double);
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) ThrowSystemError(errno, "shm_open");
+  // ftruncate zero-fills, so the matrix starts out zeroed like S21Matrix
+  void* address = MAP_FAILED;
+  int error = 0;
+  if (ftruncate(fd, (off_t)length) != 0) {
+    error = errno;
+  } else {
+    address =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) error = errno;
+  }
+  close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    ThrowSystemError(error, "mmap");
+  }
+
+  Header* header = new (address) Header{{0}, {1}, rows, cols, offset};
+  header->magic.store(kMagic, std::memory_order_release);
+  return Wrap(name, address, length, false);
+}
+
+S21Matrix S21SharedMemory::Publish(const std::string& name,
+                                   const S21Matrix& m) {
+  S21Matrix result = Create(name, m.getRows(), m.getCols());
+  std::copy(m.begin(), m.end(), result.matrix_);
+  return result;
+}
+
+S21Matrix S21SharedMemory::Attach(const std::string& name,
+                                  S21ShmAccess access) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) ThrowSystemError(errno, "shm_open");
+  struct stat info;
+  void* address = MAP_FAILED;
+  std::size_t length = 0;
+  int error = EINVAL;
+  if (fstat(fd, &info) != 0) {
+    error = errno;
+  } else if ((std::size_t)info.st_size >= sizeof(Header)) {
+    length = (std::size_t)info.st_size;
+    address =
+        mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) error = errno;
+  }
+  close(fd);
+  if (address == MAP_FAILED) ThrowSystemError(error, "shm_open");
+
+  Header* header = static_cast<Header*>(address);
+  std::size_t page = (std::size_t)sysconf(_SC_PAGESIZE);
+  bool valid = header->magic.load(std::memory_order_acquire) == kMagic &&
+               header->rows > 0 && header->cols > 0 &&
+               header->offset % page == 0 &&
+               header->offset + (std::size_t)header->rows * header->cols *
+                                    sizeof(double) <=
+                   length;
+  // no new references once the last holder has started unlinking the name
+  int refs = valid ? header->refs.load() : 0;
+  while (refs > 0 && !header->refs.compare_exchange_weak(refs, refs + 1)) {
+  }
+  if (refs == 0) {
+    munmap(address, length);
+    ThrowSystemError(valid ? ENOENT : EINVAL, "shm_open");
+  }
+
+  bool read_only = access == S21ShmAccess::kReadOnly;
+  if (read_only && mprotect(static_cast<char*>(address) + header->offset,
+                            length - header->offset, PROT_READ) != 0) {
+    error = errno;
+    Release(name, address, length);
+    ThrowSystemError(error, "mprotect");
+  }
+  return Wrap(name, address, length, read_only);
+}
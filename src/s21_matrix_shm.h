@@ -0,0 +1,32 @@
+#ifndef S21_MATRIX_S21MATRIX_SHM_H
+#define S21_MATRIX_S21MATRIX_SHM_H
+
+#include <cstddef>
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+enum class S21ShmAccess { kReadOnly, kReadWrite };
+
+// Matrices whose elements live in a named POSIX shared memory segment, so
+// processes on one host hand them over without copying. Every matrix using a
+// segment, in any process, holds a reference to it and the name is unlinked
+// with the last one, so keep a published matrix alive until the readers have
+// attached. Failed system calls throw std::system_error.
+class S21SharedMemory {
+ public:
+  // new segment, fails when the name is taken
+  static S21Matrix Create(const std::string& name, int rows, int cols);
+  static S21Matrix Publish(const std::string& name, const S21Matrix& m);
+
+  // maps an existing segment; writes through a read-write matrix are seen by
+  // every process, a read-only one copies itself on its first write. The
+  // reference count lives in the segment, so both need write permission.
+  static S21Matrix Attach(const std::string& name, S21ShmAccess access);
+
+ private:
+  static S21Matrix Wrap(const std::string& name, void* address,
+                        std::size_t length, bool read_only);
+};
+
+#endif  // S21_MATRIX_S21MATRIX_SHM_H
@@ -0,0 +1,665 @@
+#include "s21_matrix_solvers.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+constexpr int kCheckpointColumns = 32;
+
+// an updated inverse this much smaller than the terms it was computed from
+// lost too many digits to cancellation
+constexpr double kCancellationLimit = 1e6;
+// one column of an updated inverse is checked every few updates
+constexpr int kDriftCheckInterval = 32;
+constexpr double kDriftTolerance = 1e-8;
+
+// in-place LU with partial pivoting of an n x n row-major matrix,
+// returns false when a zero pivot column is met
+template <typename T>
+bool FactorLU(std::vector<T>& lu, std::vector<int>& perm, int n, int* sign,
+              const std::function<void(double)>* checkpoint = nullptr) {
+  bool regular = true;
+  *sign = 1;
+  perm.resize(n);
+  for (int i = 0; i < n; ++i) {
+    perm[i] = i;
+  }
+
+  for (int k = 0; k < n; ++k) {
+    if (checkpoint && k % kCheckpointColumns == 0) (*checkpoint)((double)k / n);
+    int pivot = k;
+    for (int i = k + 1; i < n; ++i) {
+      if (fabs(lu[i * n + k]) > fabs(lu[pivot * n + k])) pivot = i;
+    }
+    if (pivot != k) {
+      std::swap_ranges(lu.begin() + k * n, lu.begin() + (k + 1) * n,
+                       lu.begin() + pivot * n);
+      std::swap(perm[k], perm[pivot]);
+      *sign = -*sign;
+    }
+
+    T diag = lu[k * n + k];
+    if (diag == 0) {
+      regular = false;
+      continue;
+    }
+    T* row_k = &lu[k * n];
+    for (int i = k + 1; i < n; ++i) {
+      T* row_i = &lu[i * n];
+      row_i[k] /= diag;
+      T factor = row_i[k];
+      for (int j = k + 1; j < n; ++j) {
+        row_i[j] -= factor * row_k[j];
+      }
+    }
+  }
+  return regular;
+}
+
+// forward and back substitution of n x nrhs permuted right-hand sides
+template <typename T>
+void SolveLU(const std::vector<T>& lu, int n, T* x, int nrhs) {
+  for (int i = 1; i < n; ++i) {
+    T* x_i = x + i * nrhs;
+    for (int k = 0; k < i; ++k) {
+      T factor = lu[i * n + k];
+      const T* x_k = x + k * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] -= factor * x_k[j];
+      }
+    }
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    T* x_i = x + i * nrhs;
+    for (int k = i + 1; k < n; ++k) {
+      T factor = lu[i * n + k];
+      const T* x_k = x + k * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] -= factor * x_k[j];
+      }
+    }
+    T diag = lu[i * n + i];
+    for (int j = 0; j < nrhs; ++j) {
+      x_i[j] /= diag;
+    }
+  }
+}
+
+S21Matrix FromRowMajor(const std::vector<double>& x, int rows, int cols) {
+  S21Matrix result(rows, cols, kS21Uninitialized);
+  std::copy_n(x.begin(), rows * cols, result.begin());
+  return result;
+}
+
+double MaxAbs(const S21Matrix& m) {
+  double result = 0;
+  for (double x : m) {
+    result = std::max(result, fabs(x));
+  }
+  return result;
+}
+
+}  // namespace
+
+// S21LU
+S21LU::S21LU(const S21Matrix& a) {
+  if (a.rows_ != a.cols_ || a.rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  n_ = a.rows_;
+  lu_.assign(a.begin(), a.end());
+  singular_ = !FactorLU(lu_, perm_, n_, &sign_);
+}
+
+S21LU::S21LU(const S21Matrix& a,
+             const std::function<void(double)>& checkpoint) {
+  if (a.rows_ != a.cols_ || a.rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  n_ = a.rows_;
+  lu_.assign(a.begin(), a.end());
+  singular_ = !FactorLU(lu_, perm_, n_, &sign_, &checkpoint);
+}
+
+int S21LU::getSize() const { return n_; }
+bool S21LU::isSingular() const { return singular_; }
+
+double S21LU::Determinant() const {
+  double result = sign_;
+  for (int i = 0; i < n_; ++i) {
+    result *= lu_[i * n_ + i];
+  }
+  return result;
+}
+
+double S21LU::LogAbsDeterminant() const {
+  double result = 0;
+  for (int i = 0; i < n_; ++i) {
+    result += log(fabs(lu_[i * n_ + i]));
+  }
+  return result;
+}
+
+int S21LU::DeterminantSign() const {
+  if (singular_) return 0;
+  int result = sign_;
+  for (int i = 0; i < n_; ++i) {
+    if (lu_[i * n_ + i] < 0) result = -result;
+  }
+  return result;
+}
+
+S21Matrix S21LU::Solve(const S21Matrix& b) const {
+  if (b.rows_ != n_ || b.cols_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(b.begin(), b.end());
+  int nrhs = b.getCols();
+  std::vector<double> permuted(x.size());
+  for (int i = 0; i < n_; ++i) {
+    std::copy_n(&x[perm_[i] * nrhs], nrhs, &permuted[i * nrhs]);
+  }
+  SolveInPlace(permuted.data(), nrhs);
+  return FromRowMajor(permuted, n_, nrhs);
+}
+
+std::vector<double> S21LU::Solve(const std::vector<double>& b) const {
+  if ((int)b.size() != n_) throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(n_);
+  for (int i = 0; i < n_; ++i) {
+    x[i] = b[perm_[i]];
+  }
+  SolveInPlace(x.data(), 1);
+  return x;
+}
+
+S21Matrix S21LU::Inverse() const {
+  std::vector<double> x(n_ * n_, 0.0);
+  for (int i = 0; i < n_; ++i) {
+    x[i * n_ + perm_[i]] = 1;
+  }
+  SolveInPlace(x.data(), n_);
+  return FromRowMajor(x, n_, n_);
+}
+
+// x holds n_ x nrhs right-hand sides, already permuted
+void S21LU::SolveInPlace(double* x, int nrhs) const {
+  if (singular_) throw std::invalid_argument("invalid matrix!");
+  SolveLU(lu_, n_, x, nrhs);
+}
+
+// S21MixedLU
+S21MixedLU::S21MixedLU(const S21Matrix& a, int max_iterations)
+    : a_(a), max_iterations_(max_iterations) {
+  if (a.rows_ != a.cols_ || a.rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  n_ = a.rows_;
+  norm_ = 0;
+  bool representable = true;
+  for (int i = 0; i < n_; ++i) {
+    double row_sum = 0;
+    for (double value : a.Row(i)) {
+      row_sum += fabs(value);
+      if (fabs(value) > FLT_MAX) representable = false;
+    }
+    norm_ = std::max(norm_, row_sum);
+  }
+
+  lu_.assign(a.begin(), a.end());
+  singular_ = !representable || !FactorLU(lu_, perm_, n_, &sign_);
+}
+
+bool S21MixedLU::isSingular() const { return singular_; }
+
+double S21MixedLU::Determinant() const {
+  if (singular_) return 0;
+
+  double result = sign_;
+  for (int i = 0; i < n_; ++i) {
+    result *= lu_[i * n_ + i];
+  }
+  return result;
+}
+
+// x_0 = LU_f \ b, then x_k+1 = x_k + LU_f \ (b - A * x_k) with the residual in
+// double until ||r|| <= ||A|| * ||x|| * eps * sqrt(n)
+S21Matrix S21MixedLU::Solve(const S21Matrix& b, S21RefinementInfo* info) const {
+  if (b.rows_ != n_ || b.cols_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  S21RefinementInfo outcome;
+  int nrhs = b.cols_;
+  S21Matrix x(n_, nrhs);
+  std::vector<float> correction(n_ * nrhs);
+  double tolerance = norm_ * DBL_EPSILON * sqrt((double)n_);
+
+  auto apply = [&](const double* rhs) {
+    for (int i = 0; i < n_; ++i) {
+      for (int j = 0; j < nrhs; ++j) {
+        correction[i * nrhs + j] = (float)rhs[perm_[i] * nrhs + j];
+      }
+    }
+    SolveLU(lu_, n_, correction.data(), nrhs);
+    double* out = x.Data();
+    bool finite = true;
+    for (int i = 0; i < n_ * nrhs; ++i) {
+      out[i] += correction[i];
+      if (!std::isfinite(out[i])) finite = false;
+    }
+    return finite;
+  };
+
+  bool finite = !singular_ && apply(b.Data());
+  S21Matrix residual(n_, nrhs, kS21Uninitialized);
+  while (finite && outcome.iterations <= max_iterations_) {
+    const double* a = a_.Data();
+    const double* xs = x.Data();
+    double* r = residual.Data();
+    std::copy(b.begin(), b.end(), r);
+    for (int i = 0; i < n_; ++i) {
+      for (int k = 0; k < n_; ++k) {
+        double factor = a[i * n_ + k];
+        for (int j = 0; j < nrhs; ++j) {
+          r[i * nrhs + j] -= factor * xs[k * nrhs + j];
+        }
+      }
+    }
+    double r_norm = 0, x_norm = 0;
+    for (int i = 0; i < n_ * nrhs; ++i) {
+      r_norm = std::max(r_norm, fabs(r[i]));
+      x_norm = std::max(x_norm, fabs(xs[i]));
+    }
+    if (r_norm <= tolerance * x_norm) {
+      outcome.converged = true;
+      break;
+    }
+    if (outcome.iterations == max_iterations_) break;
+    finite = apply(r);
+    ++outcome.iterations;
+  }
+
+  if (!outcome.converged) {
+    outcome.fell_back = true;
+    x = S21LU(a_).Solve(b);
+  }
+  if (info) *info = outcome;
+  return x;
+}
+
+S21Matrix S21MixedLU::Inverse(S21RefinementInfo* info) const {
+  S21Matrix identity(n_, n_);
+  for (int i = 0; i < n_; ++i) {
+    identity.At(i, i) = 1;
+  }
+  return Solve(identity, info);
+}
+
+// S21Cholesky
+S21Cholesky::S21Cholesky(const S21Matrix& a) {
+  if (a.rows_ != a.cols_ || a.rows_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  n_ = a.rows_;
+  l_.assign(n_ * n_, 0.0);
+  for (int j = 0; j < n_; ++j) {
+    double* row_j = &l_[j * n_];
+    double sum = a.At(j, j);
+    for (int k = 0; k < j; ++k) {
+      sum -= row_j[k] * row_j[k];
+    }
+    if (sum <= 0)
+      throw std::invalid_argument("matrix is not positive definite!");
+    row_j[j] = sqrt(sum);
+
+    for (int i = j + 1; i < n_; ++i) {
+      double* row_i = &l_[i * n_];
+      double value = a.At(i, j);
+      for (int k = 0; k < j; ++k) {
+        value -= row_i[k] * row_j[k];
+      }
+      row_i[j] = value / row_j[j];
+    }
+  }
+}
+
+int S21Cholesky::getSize() const { return n_; }
+
+double S21Cholesky::Determinant() const {
+  double result = 1;
+  for (int i = 0; i < n_; ++i) {
+    result *= l_[i * n_ + i];
+  }
+  return result * result;
+}
+
+double S21Cholesky::LogDeterminant() const {
+  double result = 0;
+  for (int i = 0; i < n_; ++i) {
+    result += log(l_[i * n_ + i]);
+  }
+  return 2 * result;
+}
+
+S21Matrix S21Cholesky::Solve(const S21Matrix& b) const {
+  if (b.rows_ != n_ || b.cols_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(b.begin(), b.end());
+  SolveInPlace(x.data(), b.getCols());
+  return FromRowMajor(x, n_, b.getCols());
+}
+
+std::vector<double> S21Cholesky::Solve(const std::vector<double>& b) const {
+  if ((int)b.size() != n_) throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(b);
+  SolveInPlace(x.data(), 1);
+  return x;
+}
+
+S21Matrix S21Cholesky::Inverse() const {
+  std::vector<double> x(n_ * n_, 0.0);
+  for (int i = 0; i < n_; ++i) {
+    x[i * n_ + i] = 1;
+  }
+  SolveInPlace(x.data(), n_);
+  return FromRowMajor(x, n_, n_);
+}
+
+void S21Cholesky::SolveInPlace(double* x, int nrhs) const {
+  // L * y = b
+  for (int i = 0; i < n_; ++i) {
+    double* x_i = x + i * nrhs;
+    for (int k = 0; k < i; ++k) {
+      double factor = l_[i * n_ + k];
+      const double* x_k = x + k * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] -= factor * x_k[j];
+      }
+    }
+    double diag = l_[i * n_ + i];
+    for (int j = 0; j < nrhs; ++j) {
+      x_i[j] /= diag;
+    }
+  }
+  // L^T * x = y
+  for (int i = n_ - 1; i >= 0; --i) {
+    double* x_i = x + i * nrhs;
+    for (int k = i + 1; k < n_; ++k) {
+      double factor = l_[k * n_ + i];
+      const double* x_k = x + k * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] -= factor * x_k[j];
+      }
+    }
+    double diag = l_[i * n_ + i];
+    for (int j = 0; j < nrhs; ++j) {
+      x_i[j] /= diag;
+    }
+  }
+}
+
+// S21QR
+S21QR::S21QR(const S21Matrix& a) {
+  if (a.rows_ < a.cols_ || a.cols_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  rows_ = a.rows_;
+  cols_ = a.cols_;
+  reflections_ = 0;
+  qr_.resize(rows_ * cols_);
+  diag_.resize(cols_);
+  std::copy(a.begin(), a.end(), qr_.begin());
+
+  for (int k = 0; k < cols_; ++k) {
+    double norm = 0;
+    for (int i = k; i < rows_; ++i) {
+      norm = hypot(norm, qr_[i * cols_ + k]);
+    }
+    if (norm != 0) {
+      if (qr_[k * cols_ + k] < 0) norm = -norm;
+      for (int i = k; i < rows_; ++i) {
+        qr_[i * cols_ + k] /= norm;
+      }
+      qr_[k * cols_ + k] += 1;
+      for (int j = k + 1; j < cols_; ++j) {
+        double s = 0;
+        for (int i = k; i < rows_; ++i) {
+          s += qr_[i * cols_ + k] * qr_[i * cols_ + j];
+        }
+        s = -s / qr_[k * cols_ + k];
+        for (int i = k; i < rows_; ++i) {
+          qr_[i * cols_ + j] += s * qr_[i * cols_ + k];
+        }
+      }
+      ++reflections_;
+    }
+    diag_[k] = -norm;
+  }
+}
+
+int S21QR::getRows() const { return rows_; }
+int S21QR::getCols() const { return cols_; }
+
+bool S21QR::isRankDeficient() const {
+  return std::find(diag_.begin(), diag_.end(), 0.0) != diag_.end();
+}
+
+double S21QR::Determinant() const {
+  if (rows_ != cols_) throw std::out_of_range("invalid size of matrix!");
+
+  double result = reflections_ % 2 ? -1 : 1;
+  for (double d : diag_) {
+    result *= d;
+  }
+  return result;
+}
+
+double S21QR::LogAbsDeterminant() const {
+  if (rows_ != cols_) throw std::out_of_range("invalid size of matrix!");
+
+  double result = 0;
+  for (double d : diag_) {
+    result += log(fabs(d));
+  }
+  return result;
+}
+
+S21Matrix S21QR::Solve(const S21Matrix& b) const {
+  if (b.rows_ != rows_ || b.cols_ < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(b.begin(), b.end());
+  SolveInPlace(x.data(), b.getCols());
+  x.resize(cols_ * b.getCols());
+  return FromRowMajor(x, cols_, b.getCols());
+}
+
+std::vector<double> S21QR::Solve(const std::vector<double>& b) const {
+  if ((int)b.size() != rows_)
+    throw std::out_of_range("invalid size of matrix!");
+
+  std::vector<double> x(b);
+  SolveInPlace(x.data(), 1);
+  x.resize(cols_);
+  return x;
+}
+
+// x holds rows_ x nrhs right-hand sides, the first cols_ rows hold the result
+void S21QR::SolveInPlace(double* x, int nrhs) const {
+  if (isRankDeficient()) throw std::invalid_argument("invalid matrix!");
+
+  // x = Q^T * b
+  std::vector<double> s(nrhs);
+  for (int k = 0; k < cols_; ++k) {
+    std::fill(s.begin(), s.end(), 0.0);
+    for (int i = k; i < rows_; ++i) {
+      double v = qr_[i * cols_ + k];
+      const double* x_i = x + i * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        s[j] += v * x_i[j];
+      }
+    }
+    double scale = -1.0 / qr_[k * cols_ + k];
+    for (int i = k; i < rows_; ++i) {
+      double v = qr_[i * cols_ + k] * scale;
+      double* x_i = x + i * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] += s[j] * v;
+      }
+    }
+  }
+  // R * x = Q^T * b
+  for (int k = cols_ - 1; k >= 0; --k) {
+    double* x_k = x + k * nrhs;
+    for (int j = 0; j < nrhs; ++j) {
+      x_k[j] /= diag_[k];
+    }
+    for (int i = 0; i < k; ++i) {
+      double factor = qr_[i * cols_ + k];
+      double* x_i = x + i * nrhs;
+      for (int j = 0; j < nrhs; ++j) {
+        x_i[j] -= factor * x_k[j];
+      }
+    }
+  }
+}
+
+// S21LowRankInverse
+S21LowRankInverse::S21LowRankInverse(const S21Matrix& a)
+    : n_(a.getRows()),
+      updates_since_check_(0),
+      drift_column_(0),
+      recomputations_(0) {
+  if (a.getRows() != a.getCols() || a.getRows() < 1)
+    throw std::out_of_range("invalid size of matrix!");
+
+  Recompute(a);
+  recomputations_ = 0;
+}
+
+S21LowRankInverse::S21LowRankInverse(const S21Matrix& a,
+                                     const S21Matrix& inverse,
+                                     double determinant)
+    : n_(a.getRows()),
+      a_(a),
+      inverse_(inverse),
+      determinant_(determinant),
+      updates_since_check_(0),
+      drift_column_(0),
+      recomputations_(0) {
+  if (a.getRows() != a.getCols() || a.getRows() < 1 ||
+      inverse.getRows() != n_ || inverse.getCols() != n_)
+    throw std::out_of_range("invalid size of matrix!");
+}
+
+const S21Matrix& S21LowRankInverse::getMatrix() const { return a_; }
+const S21Matrix& S21LowRankInverse::getInverse() const { return inverse_; }
+double S21LowRankInverse::getDeterminant() const { return determinant_; }
+int S21LowRankInverse::getRecomputations() const { return recomputations_; }
+
+// (A + U V^T)^-1 = A^-1 - W C^-1 Z with W = A^-1 U, Z = V^T A^-1 and
+// C = I + V^T W; det(A + U V^T) = det(A) * det(C)
+void S21LowRankInverse::Update(const S21Matrix& u, const S21Matrix& v) {
+  if (u.getRows() != n_ || v.getRows() != n_ || u.getCols() != v.getCols())
+    throw std::out_of_range("invalid size of matrix!");
+
+  S21Matrix vt = v.Transpose();
+  S21Matrix updated = a_ + u * vt;
+  S21Matrix w = inverse_ * u;
+  S21Matrix z = vt * inverse_;
+  S21Matrix capacitance = vt * w;
+  for (int i = 0; i < capacitance.getRows(); ++i) {
+    capacitance(i, i) += 1;
+  }
+  S21LU lu(capacitance);
+  if (!lu.isSingular()) {
+    S21Matrix correction = w * lu.Solve(z);
+    S21Matrix inverse = inverse_ - correction;
+    double terms = std::max(MaxAbs(inverse_), MaxAbs(correction));
+    if (terms <= kCancellationLimit * MaxAbs(inverse)) {
+      double determinant = determinant_ * lu.Determinant();
+      std::swap(a_, updated);
+      std::swap(inverse_, inverse);
+      determinant_ = determinant;
+      if (++updates_since_check_ < kDriftCheckInterval || !HasDrifted())
+        return;
+      // the drifted state is a_, rebuild from it
+      updated = a_;
+    }
+  }
+  Recompute(updated);
+}
+
+void S21LowRankInverse::ReplaceRow(int row, const std::vector<double>& values) {
+  if (row < 0 || row >= n_) throw std::out_of_range("index is out of range");
+  if ((int)values.size() != n_)
+    throw std::out_of_range("invalid size of matrix!");
+
+  // A + e_row * (values - a_row)^T
+  S21Matrix u(n_, 1), v(n_, 1);
+  u(row, 0) = 1;
+  const double* a = std::as_const(a_).Data() + row * n_;
+  for (int j = 0; j < n_; ++j) {
+    v(j, 0) = values[j] - a[j];
+  }
+  Update(u, v);
+}
+
+void S21LowRankInverse::ReplaceColumn(int col,
+                                      const std::vector<double>& values) {
+  if (col < 0 || col >= n_) throw std::out_of_range("index is out of range");
+  if ((int)values.size() != n_)
+    throw std::out_of_range("invalid size of matrix!");
+
+  // A + (values - a_col) * e_col^T
+  S21Matrix u(n_, 1), v(n_, 1);
+  v(col, 0) = 1;
+  const double* a = std::as_const(a_).Data();
+  for (int i = 0; i < n_; ++i) {
+    u(i, 0) = values[i] - a[i * n_ + col];
+  }
+  Update(u, v);
+}
+
+// full factorization of a, the state is only replaced when a is regular
+void S21LowRankInverse::Recompute(const S21Matrix& a) {
+  S21LU lu(a);
+  if (lu.isSingular()) throw std::invalid_argument("invalid matrix!");
+  S21Matrix inverse = lu.Inverse();
+  a_ = a;
+  inverse_ = std::move(inverse);
+  determinant_ = lu.Determinant();
+  updates_since_check_ = 0;
+  ++recomputations_;
+}
+
+// residual of A x = e_j for one column x of the inverse, the checked column
+// rotates so every column is looked at eventually
+bool S21LowRankInverse::HasDrifted() {
+  int j = drift_column_;
+  drift_column_ = (drift_column_ + 1) % n_;
+  updates_since_check_ = 0;
+
+  // read through const, a_ may carry a cache or copy-on-write from the
+  // matrix it was built from
+  const double* a = std::as_const(a_).Data();
+  const double* x = std::as_const(inverse_).Data();
+  double residual = 0, x_norm = 0;
+  for (int i = 0; i < n_; ++i) {
+    x_norm = std::max(x_norm, fabs(x[i * n_ + j]));
+  }
+  for (int i = 0; i < n_; ++i) {
+    double sum = i == j ? -1 : 0;
+    for (int k = 0; k < n_; ++k) {
+      sum += a[i * n_ + k] * x[k * n_ + j];
+    }
+    residual = std::max(residual, fabs(sum));
+  }
+  return !(residual <= kDriftTolerance * n_ * MaxAbs(a_) * x_norm);
+}
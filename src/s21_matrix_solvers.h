@@ -0,0 +1,153 @@
+#ifndef S21_MATRIX_S21MATRIX_SOLVERS_H
+#define S21_MATRIX_S21MATRIX_SOLVERS_H
+
+#include <functional>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// LU decomposition with partial pivoting: P * A = L * U
+class S21LU {
+ public:
+  explicit S21LU(const S21Matrix& a);
+  // checkpoint receives the completed fraction every few pivot columns,
+  // an exception thrown from it aborts the factorization
+  S21LU(const S21Matrix& a, const std::function<void(double)>& checkpoint);
+
+  // accessors
+  int getSize() const;
+  bool isSingular() const;
+
+  // operations
+  double Determinant() const;
+  double LogAbsDeterminant() const;
+  int DeterminantSign() const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  S21Matrix Inverse() const;
+
+ private:
+  int n_;
+  int sign_;
+  bool singular_;
+  std::vector<double> lu_;
+  std::vector<int> perm_;
+
+  // helpers
+  void SolveInPlace(double* x, int nrhs) const;
+};
+
+// LU decomposition computed in single precision; solutions are refined with
+// double precision residuals and fall back to S21LU when refinement stalls
+class S21MixedLU {
+ public:
+  explicit S21MixedLU(const S21Matrix& a, int max_iterations = 30);
+
+  // accessors
+  bool isSingular() const;
+
+  // operations
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix& b, S21RefinementInfo* info = nullptr) const;
+  S21Matrix Inverse(S21RefinementInfo* info = nullptr) const;
+
+ private:
+  S21Matrix a_;
+  int n_;
+  int max_iterations_;
+  int sign_;
+  bool singular_;
+  double norm_;
+  std::vector<float> lu_;
+  std::vector<int> perm_;
+};
+
+// Cholesky decomposition of a symmetric positive definite matrix: A = L * L^T
+class S21Cholesky {
+ public:
+  explicit S21Cholesky(const S21Matrix& a);
+
+  // accessors
+  int getSize() const;
+
+  // operations
+  double Determinant() const;
+  double LogDeterminant() const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+  S21Matrix Inverse() const;
+
+ private:
+  int n_;
+  std::vector<double> l_;
+
+  // helpers
+  void SolveInPlace(double* x, int nrhs) const;
+};
+
+// Householder QR decomposition: A = Q * R, rows >= cols.
+// Solve returns the least squares solution when A is not square.
+class S21QR {
+ public:
+  explicit S21QR(const S21Matrix& a);
+
+  // accessors
+  int getRows() const;
+  int getCols() const;
+  bool isRankDeficient() const;
+
+  // operations
+  double Determinant() const;
+  double LogAbsDeterminant() const;
+  S21Matrix Solve(const S21Matrix& b) const;
+  std::vector<double> Solve(const std::vector<double>& b) const;
+
+ private:
+  int rows_, cols_;
+  int reflections_;
+  std::vector<double> qr_;
+  std::vector<double> diag_;
+
+  // helpers
+  void SolveInPlace(double* x, int nrhs) const;
+};
+
+// Inverse and determinant of a square matrix kept current under low-rank
+// changes A + U * V^T with the Sherman-Morrison-Woodbury formula, O(n^2 k)
+// for n x k U and V. An update with a singular k x k capacitance matrix or
+// heavy cancellation, and a tracked inverse that drifted from the tracked
+// matrix, are redone by a full factorization. A change that makes the matrix
+// singular throws std::invalid_argument and leaves the state as it was.
+class S21LowRankInverse {
+ public:
+  explicit S21LowRankInverse(const S21Matrix& a);
+  // starts from a known inverse and determinant of a
+  S21LowRankInverse(const S21Matrix& a, const S21Matrix& inverse,
+                    double determinant);
+
+  // accessors
+  const S21Matrix& getMatrix() const;
+  const S21Matrix& getInverse() const;
+  double getDeterminant() const;
+  int getRecomputations() const;
+
+  // operations
+  void Update(const S21Matrix& u, const S21Matrix& v);
+  void ReplaceRow(int row, const std::vector<double>& values);
+  void ReplaceColumn(int col, const std::vector<double>& values);
+
+ private:
+  int n_;
+  S21Matrix a_;
+  S21Matrix inverse_;
+  double determinant_;
+  int updates_since_check_;
+  int drift_column_;
+  int recomputations_;
+
+  // helpers
+  void Recompute(const S21Matrix& a);
+  bool HasDrifted();
+};
+
+#endif  // S21_MATRIX_S21MATRIX_SOLVERS_H
@@ -0,0 +1,210 @@
+#include "s21_matrix_tiled.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+
+namespace {
+
+constexpr int kTile = S21TiledMatrix::kTile;
+constexpr int kTileSize = kTile * kTile;
+
+std::uint64_t MortonCode(std::uint32_t row, std::uint32_t col) {
+  std::uint64_t code = 0;
+  for (int bit = 0; bit < 32; ++bit) {
+    code |= (std::uint64_t)((row >> bit) & 1) << (2 * bit + 1);
+    code |= (std::uint64_t)((col >> bit) & 1) << (2 * bit);
+  }
+  return code;
+}
+
+// c += a * b for three full tiles
+void MultiplyTiles(const double* a, const double* b, double* c) {
+  for (int i = 0; i < kTile; ++i) {
+    double* out = c + i * kTile;
+    for (int p = 0; p < kTile; ++p) {
+      double factor = a[i * kTile + p];
+      const double* row = b + p * kTile;
+      for (int j = 0; j < kTile; ++j) {
+        out[j] += factor * row[j];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+S21TiledMatrix::S21TiledMatrix(int rows, int cols, S21TileOrder order) {
+  if (rows < 1 || cols < 1) throw std::out_of_range("invalid length!");
+
+  rows_ = rows;
+  cols_ = cols;
+  tile_rows_ = (rows + kTile - 1) / kTile;
+  tile_cols_ = (cols + kTile - 1) / kTile;
+  order_ = order;
+  int tiles = tile_rows_ * tile_cols_;
+  slots_.resize(tiles);
+  std::iota(slots_.begin(), slots_.end(), 0);
+  if (order_ == S21TileOrder::kMorton) {
+    // ranks of the Z-order codes, dense even when the grid is not a square
+    // power of two
+    std::vector<int> by_code(tiles);
+    std::iota(by_code.begin(), by_code.end(), 0);
+    std::sort(by_code.begin(), by_code.end(), [this](int x, int y) {
+      return MortonCode(x / tile_cols_, x % tile_cols_) <
+             MortonCode(y / tile_cols_, y % tile_cols_);
+    });
+    for (int slot = 0; slot < tiles; ++slot) {
+      slots_[by_code[slot]] = slot;
+    }
+  }
+  data_.assign((std::size_t)tiles * kTileSize, 0.0);
+}
+
+S21TiledMatrix::S21TiledMatrix(const S21Matrix& m, S21TileOrder order)
+    : S21TiledMatrix(m.getRows(), m.getCols(), order) {
+  const double* source = m.Data();
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      double* tile = Tile(ti, tj);
+      int height = std::min(kTile, rows_ - ti * kTile);
+      int width = std::min(kTile, cols_ - tj * kTile);
+      for (int i = 0; i < height; ++i) {
+        std::copy_n(source + (ti * kTile + i) * cols_ + tj * kTile, width,
+                    tile + i * kTile);
+      }
+    }
+  }
+}
+
+// accessors
+int S21TiledMatrix::getRows() const { return rows_; }
+int S21TiledMatrix::getCols() const { return cols_; }
+S21TileOrder S21TiledMatrix::getOrder() const { return order_; }
+
+// operations
+S21Matrix S21TiledMatrix::ToMatrix() const {
+  S21Matrix result(rows_, cols_, kS21Uninitialized);
+  double* target = result.Data();
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      const double* tile = Tile(ti, tj);
+      int height = std::min(kTile, rows_ - ti * kTile);
+      int width = std::min(kTile, cols_ - tj * kTile);
+      for (int i = 0; i < height; ++i) {
+        std::copy_n(tile + i * kTile, width,
+                    target + (ti * kTile + i) * cols_ + tj * kTile);
+      }
+    }
+  }
+  return result;
+}
+
+bool S21TiledMatrix::EqMatrix(const S21TiledMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  // padding is zero in both, so whole tiles can be compared
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      const double* a = Tile(ti, tj);
+      const double* b = other.Tile(ti, tj);
+      for (int k = 0; k < kTileSize; ++k) {
+        if (fabs(a[k] - b[k]) > 1e-7) return false;
+      }
+    }
+  }
+  return true;
+}
+
+void S21TiledMatrix::SumMatrix(const S21TiledMatrix& other) {
+  ForEachTilePair(other, [](double& a, double b) { a += b; });
+}
+
+void S21TiledMatrix::SubMatrix(const S21TiledMatrix& other) {
+  ForEachTilePair(other, [](double& a, double b) { a -= b; });
+}
+
+void S21TiledMatrix::MulNumber(const double num) {
+  for (double& x : data_) {
+    x *= num;
+  }
+}
+
+void S21TiledMatrix::MulMatrix(const S21TiledMatrix& other) {
+  if (cols_ != other.rows_) throw std::logic_error("invalid size of matrix!");
+
+  S21TiledMatrix result(rows_, other.cols_, order_);
+  for (int ti = 0; ti < result.tile_rows_; ++ti) {
+    for (int tj = 0; tj < result.tile_cols_; ++tj) {
+      double* c = result.Tile(ti, tj);
+      for (int tp = 0; tp < tile_cols_; ++tp) {
+        MultiplyTiles(Tile(ti, tp), other.Tile(tp, tj), c);
+      }
+    }
+  }
+  *this = std::move(result);
+}
+
+S21TiledMatrix S21TiledMatrix::Transpose() const {
+  S21TiledMatrix result(cols_, rows_, order_);
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      const double* tile = Tile(ti, tj);
+      double* target = result.Tile(tj, ti);
+      for (int i = 0; i < kTile; ++i) {
+        for (int j = 0; j < kTile; ++j) {
+          target[j * kTile + i] = tile[i * kTile + j];
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// element access
+double& S21TiledMatrix::operator()(int row, int col) {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+    throw std::out_of_range("index is out of range");
+  return Tile(row / kTile, col / kTile)[row % kTile * kTile + col % kTile];
+}
+
+double S21TiledMatrix::operator()(int row, int col) const {
+  if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+    throw std::out_of_range("index is out of range");
+  return Tile(row / kTile, col / kTile)[row % kTile * kTile + col % kTile];
+}
+
+// helpers
+double* S21TiledMatrix::Tile(int tile_row, int tile_col) {
+  return data_.data() +
+         (std::size_t)slots_[tile_row * tile_cols_ + tile_col] * kTileSize;
+}
+
+const double* S21TiledMatrix::Tile(int tile_row, int tile_col) const {
+  return data_.data() +
+         (std::size_t)slots_[tile_row * tile_cols_ + tile_col] * kTileSize;
+}
+
+// applies combine(this element, other element) to matching elements, the
+// tile orders of the two may differ
+template <typename Combine>
+void S21TiledMatrix::ForEachTilePair(const S21TiledMatrix& other,
+                                     const Combine& combine) {
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::out_of_range("invalid size of matrix!");
+
+  if (order_ == other.order_) {
+    for (std::size_t k = 0; k < data_.size(); ++k) {
+      combine(data_[k], other.data_[k]);
+    }
+    return;
+  }
+  for (int ti = 0; ti < tile_rows_; ++ti) {
+    for (int tj = 0; tj < tile_cols_; ++tj) {
+      double* a = Tile(ti, tj);
+      const double* b = other.Tile(ti, tj);
+      for (int k = 0; k < kTileSize; ++k) {
+        combine(a[k], b[k]);
+      }
+    }
+  }
+}
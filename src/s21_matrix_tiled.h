@@ -0,0 +1,59 @@
+#ifndef S21_MATRIX_S21MATRIX_TILED_H
+#define S21_MATRIX_S21MATRIX_TILED_H
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// order of the tiles in memory; kMorton interleaves the bits of the tile
+// row and column (Z-order), so nearby tiles stay close at every scale
+enum class S21TileOrder { kRowMajor, kMorton };
+
+// Matrix stored as kTile x kTile row-major tiles, for cache-friendly
+// transposes, products and recursive algorithms on large matrices. Edge
+// tiles are padded with zeros. Errors are reported like S21Matrix does.
+class S21TiledMatrix {
+ public:
+  // 8 KiB of doubles per tile
+  static constexpr int kTile = 32;
+
+  S21TiledMatrix(int rows, int cols,
+                 S21TileOrder order = S21TileOrder::kMorton);
+  explicit S21TiledMatrix(const S21Matrix& m,
+                          S21TileOrder order = S21TileOrder::kMorton);
+
+  // accessors
+  int getRows() const;
+  int getCols() const;
+  S21TileOrder getOrder() const;
+
+  // operations
+  S21Matrix ToMatrix() const;
+  bool EqMatrix(const S21TiledMatrix& other) const;
+  void SumMatrix(const S21TiledMatrix& other);
+  void SubMatrix(const S21TiledMatrix& other);
+  void MulNumber(const double num);
+  void MulMatrix(const S21TiledMatrix& other);
+  S21TiledMatrix Transpose() const;
+
+  // element access
+  double& operator()(int row, int col);
+  double operator()(int row, int col) const;
+
+ private:
+  int rows_, cols_;
+  int tile_rows_, tile_cols_;
+  S21TileOrder order_;
+  // slot in data_ of the tile at (tile row, tile column), row-major indexed
+  std::vector<int> slots_;
+  std::vector<double> data_;
+
+  // helpers
+  double* Tile(int tile_row, int tile_col);
+  const double* Tile(int tile_row, int tile_col) const;
+  template <typename Combine>
+  void ForEachTilePair(const S21TiledMatrix& other, const Combine& combine);
+};
+
+#endif  // S21_MATRIX_S21MATRIX_TILED_H
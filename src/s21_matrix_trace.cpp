@@ -0,0 +1,217 @@
+#include "s21_matrix_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define S21_PROBE3(probe, a, b, c) STAP_PROBE3(s21_matrix, probe, a, b, c)
+#define S21_PROBE4(probe, a, b, c, d) \
+  STAP_PROBE4(s21_matrix, probe, a, b, c, d)
+#else
+#define S21_PROBE3(probe, a, b, c) (void)0
+#define S21_PROBE4(probe, a, b, c, d) (void)0
+#endif
+
+namespace {
+
+constexpr std::size_t kRetainedRings = S21_MATRIX_TRACE_RETAINED_THREADS;
+
+// one event; sequence is 2 * index + 1 while event index is written to the
+// slot and 2 * index + 2 once it is complete, so that a reader can tell a
+// torn or overwritten copy from a good one
+struct Slot {
+  std::atomic<std::uint64_t> sequence{0};
+  std::atomic<const char*> name{nullptr};
+  std::atomic<int> rows{0}, cols{0};
+  std::atomic<std::uint64_t> start{0}, end{0};
+  std::atomic<std::size_t> bytes{0};
+};
+
+// written only by the thread that owns it; head counts every event ever
+// pushed and the slot of event i is i % capacity. A ring outlives its
+// thread and is handed to a later one, head keeps counting then.
+struct Ring {
+  static constexpr std::uint64_t kCapacity = S21_MATRIX_TRACE_CAPACITY;
+
+  int thread;
+  std::atomic<std::uint64_t> head{0};
+  std::atomic<std::uint64_t> cleared{0};
+  Slot slots[kCapacity];
+};
+
+std::mutex registry_mutex;
+// every ring, for the dumps
+std::vector<std::shared_ptr<Ring>> registry;
+// rings of finished threads, oldest first; their events are still dumped
+std::deque<Ring*> finished;
+
+thread_local std::size_t thread_bytes = 0;
+
+// a ring whose events were all cleared, else the oldest finished one once
+// kRetainedRings are kept, else a new one
+Ring* AcquireRing() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto reused = std::find_if(finished.begin(), finished.end(), [](Ring* ring) {
+    return ring->cleared.load() == ring->head.load();
+  });
+  if (reused == finished.end() && finished.size() >= kRetainedRings)
+    reused = finished.begin();
+  if (reused != finished.end()) {
+    Ring* ring = *reused;
+    finished.erase(reused);
+    ring->cleared.store(ring->head.load());
+    return ring;
+  }
+  auto created = std::make_shared<Ring>();
+  created->thread = (int)registry.size() + 1;
+  registry.push_back(created);
+  return created.get();
+}
+
+enum class RingState { kNone, kOwned, kReleased };
+
+thread_local Ring* thread_ring = nullptr;
+thread_local RingState thread_ring_state = RingState::kNone;
+
+// gives the ring back when its thread exits
+struct RingRelease {
+  ~RingRelease() {
+    thread_ring_state = RingState::kReleased;
+    if (!thread_ring) return;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    finished.push_back(thread_ring);
+    thread_ring = nullptr;
+  }
+};
+
+// null when the ring could not be allocated or the thread is exiting, its
+// events are dropped then
+Ring* ThreadRing() noexcept {
+  if (thread_ring_state == RingState::kNone) {
+    thread_ring_state = RingState::kOwned;
+    try {
+      thread_local RingRelease release;
+      thread_ring = AcquireRing();
+    } catch (...) {
+      thread_ring = nullptr;
+    }
+  }
+  return thread_ring;
+}
+
+std::uint64_t Now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+// events of ring that were complete and not overwritten while they were
+// copied
+std::vector<S21TraceEvent> Snapshot(const Ring& ring) {
+  std::uint64_t head = ring.head.load(std::memory_order_acquire);
+  std::uint64_t first = head > Ring::kCapacity ? head - Ring::kCapacity : 0;
+  first = std::max(first, ring.cleared.load());
+  std::vector<S21TraceEvent> result;
+  for (std::uint64_t i = first; i < head; ++i) {
+    const Slot& slot = ring.slots[i % Ring::kCapacity];
+    std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * i + 2) continue;
+    S21TraceEvent event;
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.rows = slot.rows.load(std::memory_order_relaxed);
+    event.cols = slot.cols.load(std::memory_order_relaxed);
+    event.start = slot.start.load(std::memory_order_relaxed);
+    event.end = slot.end.load(std::memory_order_relaxed);
+    event.bytes = slot.bytes.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+      result.push_back(event);
+  }
+  return result;
+}
+
+void WriteString(std::ostream& out, const char* text) {
+  out << '"';
+  for (; *text; ++text) {
+    if (*text == '"' || *text == '\\') out << '\\';
+    out << *text;
+  }
+  out << '"';
+}
+
+}  // namespace
+
+S21TraceScope::S21TraceScope(const char* name, int rows, int cols) noexcept {
+  S21_PROBE3(operation_begin, name, rows, cols);
+  event_.name = name;
+  event_.rows = rows;
+  event_.cols = cols;
+  event_.bytes = thread_bytes;
+  event_.start = Now();
+}
+
+S21TraceScope::~S21TraceScope() noexcept {
+  event_.end = Now();
+  event_.bytes = thread_bytes - event_.bytes;
+  S21_PROBE4(operation_end, event_.name, event_.rows, event_.cols,
+             event_.bytes);
+  Ring* ring = ThreadRing();
+  if (!ring) return;
+  std::uint64_t head = ring->head.load(std::memory_order_relaxed);
+  Slot& slot = ring->slots[head % Ring::kCapacity];
+  slot.sequence.store(2 * head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.name.store(event_.name, std::memory_order_relaxed);
+  slot.rows.store(event_.rows, std::memory_order_relaxed);
+  slot.cols.store(event_.cols, std::memory_order_relaxed);
+  slot.start.store(event_.start, std::memory_order_relaxed);
+  slot.end.store(event_.end, std::memory_order_relaxed);
+  slot.bytes.store(event_.bytes, std::memory_order_relaxed);
+  slot.sequence.store(2 * head + 2, std::memory_order_release);
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+void S21TraceAllocation(std::size_t bytes) noexcept { thread_bytes += bytes; }
+
+void S21WriteChromeTrace(std::ostream& out) {
+  std::vector<std::shared_ptr<Ring>> rings;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    rings = registry;
+  }
+
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+  out << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  bool first = true;
+  for (const std::shared_ptr<Ring>& ring : rings) {
+    for (const S21TraceEvent& event : Snapshot(*ring)) {
+      out << (first ? "\n" : ",\n") << "{\"name\":";
+      WriteString(out, event.name);
+      out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->thread
+          << ",\"ts\":" << event.start / 1000.0
+          << ",\"dur\":" << (event.end - event.start) / 1000.0
+          << ",\"args\":{\"rows\":" << event.rows << ",\"cols\":" << event.cols
+          << ",\"bytes\":" << event.bytes << "}}";
+      first = false;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void S21ClearTrace() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  for (const std::shared_ptr<Ring>& ring : registry) {
+    ring->cleared.store(ring->head.load());
+  }
+}
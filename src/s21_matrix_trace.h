@@ -0,0 +1,67 @@
+#ifndef S21_MATRIX_S21MATRIX_TRACE_H
+#define S21_MATRIX_S21MATRIX_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Operations of S21Matrix are traced when the library is built with
+// -DS21_MATRIX_TRACING; otherwise S21_TRACE expands to nothing. Every thread
+// records into its own ring of the last S21_MATRIX_TRACE_CAPACITY events,
+// without locks. The rings of the last S21_MATRIX_TRACE_RETAINED_THREADS
+// finished threads are kept for the dumps; older ones, and any whose events
+// were cleared, are handed to new threads, so the memory held is bounded by
+// the threads alive at once. With <sys/sdt.h> available each operation is
+// also a pair of USDT probes, s21_matrix:operation_begin(name, rows, cols)
+// and s21_matrix:operation_end(name, rows, cols, bytes), for perf or
+// bpftrace.
+#ifndef S21_MATRIX_TRACE_CAPACITY
+#define S21_MATRIX_TRACE_CAPACITY 4096
+#endif
+#ifndef S21_MATRIX_TRACE_RETAINED_THREADS
+#define S21_MATRIX_TRACE_RETAINED_THREADS 16
+#endif
+
+struct S21TraceEvent {
+  const char* name;
+  int rows, cols;
+  // nanoseconds since the first traced event of the process
+  std::uint64_t start, end;
+  // allocated by the thread while the operation ran
+  std::size_t bytes;
+};
+
+// records one event from construction to destruction; name must be a string
+// literal
+class S21TraceScope {
+ public:
+  S21TraceScope(const char* name, int rows, int cols) noexcept;
+  S21TraceScope(const S21TraceScope&) = delete;
+  S21TraceScope& operator=(const S21TraceScope&) = delete;
+  ~S21TraceScope() noexcept;
+
+ private:
+  S21TraceEvent event_;
+};
+
+// adds to the byte count of the operations running on this thread
+void S21TraceAllocation(std::size_t bytes) noexcept;
+// Chrome trace-event JSON (chrome://tracing, Perfetto) of the events still
+// held by the rings of all threads. It may run while other threads trace:
+// events written or overwritten during the dump are left out, so it is
+// complete only once the traced threads are idle.
+void S21WriteChromeTrace(std::ostream& out);
+void S21ClearTrace();
+
+#ifdef S21_MATRIX_TRACING
+#define S21_TRACE_CONCAT_(a, b) a##b
+#define S21_TRACE_NAME_(line) S21_TRACE_CONCAT_(s21_trace_scope_, line)
+#define S21_TRACE(name, rows, cols) \
+  S21TraceScope S21_TRACE_NAME_(__LINE__)(name, rows, cols)
+#define S21_TRACE_ALLOCATION(bytes) S21TraceAllocation(bytes)
+#else
+#define S21_TRACE(name, rows, cols) (void)0
+#define S21_TRACE_ALLOCATION(bytes) (void)0
+#endif
+
+#endif  // S21_MATRIX_S21MATRIX_TRACE_H
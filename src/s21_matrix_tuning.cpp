@@ -0,0 +1,68 @@
+#include "s21_matrix_tuning.h"
+
+#include <stdlib.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+S21TuningConfig LoadStartupTuning() {
+  S21TuningConfig config;
+  const char* path = getenv("S21_MATRIX_TUNING");
+  S21LoadTuning(path ? path : "s21_matrix_tuning.conf", config);
+  return config;
+}
+
+S21TuningConfig& Current() {
+  static S21TuningConfig config = LoadStartupTuning();
+  return config;
+}
+
+template <typename T>
+void ReadPositive(std::istringstream& in, T& field, T minimum) {
+  T value;
+  if (in >> value && value >= minimum) field = value;
+}
+
+}  // namespace
+
+const S21TuningConfig& S21Tuning() { return Current(); }
+
+void S21SetTuning(const S21TuningConfig& config) { Current() = config; }
+
+bool S21LoadTuning(const std::string& path, S21TuningConfig& config) {
+  std::ifstream file(path);
+  if (!file) return false;
+
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream in(line.substr(0, line.find('#')));
+    std::string key;
+    if (!(in >> key)) continue;
+    if (key == "gemm_depth_block") {
+      ReadPositive(in, config.gemm_depth_block, 1);
+    } else if (key == "gemm_width_block") {
+      ReadPositive(in, config.gemm_width_block, 1);
+    } else if (key == "transpose_block") {
+      ReadPositive(in, config.transpose_block, 1);
+    } else if (key == "parallel_grain") {
+      ReadPositive(in, config.parallel_grain, 1L);
+    } else if (key == "elementwise_parallel_min") {
+      ReadPositive(in, config.elementwise_parallel_min, 0L);
+    }
+  }
+  return true;
+}
+
+bool S21SaveTuning(const std::string& path, const S21TuningConfig& config) {
+  std::ofstream file(path);
+  file << "# written by make tune\n"
+       << "gemm_depth_block " << config.gemm_depth_block << '\n'
+       << "gemm_width_block " << config.gemm_width_block << '\n'
+       << "transpose_block " << config.transpose_block << '\n'
+       << "parallel_grain " << config.parallel_grain << '\n'
+       << "elementwise_parallel_min " << config.elementwise_parallel_min
+       << '\n';
+  return (bool)file;
+}
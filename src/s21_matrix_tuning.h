@@ -0,0 +1,35 @@
+#ifndef S21_MATRIX_S21MATRIX_TUNING_H
+#define S21_MATRIX_S21MATRIX_TUNING_H
+
+#include <climits>
+#include <string>
+
+// Host-specific performance parameters. They are read once, on first use,
+// from the file named by the S21_MATRIX_TUNING environment variable or else
+// s21_matrix_tuning.conf in the working directory, as "key value" lines
+// written by `make tune`. Missing files, keys or invalid values keep the
+// defaults below.
+struct S21TuningConfig {
+  // cache blocking of s21_kernels::Gemm, in rows of b and columns of c
+  int gemm_depth_block = 256;
+  int gemm_width_block = 512;
+  // square blocks of Transpose
+  int transpose_block = 32;
+  // about this many flops per chunk of CalcComplements and Determinants
+  long parallel_grain = 1L << 16;
+  // Sum, Sub and MulNumber run on the default executor from this many
+  // elements on, so 0 splits them always and kSerialOnly never
+  static constexpr long kSerialOnly = LONG_MAX;
+  long elementwise_parallel_min = 1L << 20;
+};
+
+const S21TuningConfig& S21Tuning();
+// for the tuner; must not race with running operations
+void S21SetTuning(const S21TuningConfig& config);
+
+// false when the file cannot be read, config keeps what it had for keys
+// that are missing or invalid
+bool S21LoadTuning(const std::string& path, S21TuningConfig& config);
+bool S21SaveTuning(const std::string& path, const S21TuningConfig& config);
+
+#endif  // S21_MATRIX_S21MATRIX_TUNING_H